@@ -0,0 +1,59 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <string>
+#include "concurrenthash.h"
+
+using namespace std;
+
+const int opsPerThread = 200000;
+
+// ChainHash protegido por un unico mutex global (lo que se usaba antes)
+struct GlobalLockHash {
+    ChainHash<string, int> hash;
+    mutex lock;
+
+    void set(const string& key, int value) {
+        lock_guard<mutex> guard(lock);
+        hash.set(key, value);
+    }
+    bool contains(const string& key) {
+        lock_guard<mutex> guard(lock);
+        return hash.contains(key);
+    }
+};
+
+// cada hilo inserta claves propias y consulta otras tantas (50% set, 50% get)
+template<typename Table>
+double run(Table& table, int nthreads) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < nthreads; t++) {
+        workers.emplace_back([&table, t]() {
+            string prefix = "t" + to_string(t) + "_";
+            for (int i = 0; i < opsPerThread; i++) {
+                if (i % 2 == 0) table.set(prefix + to_string(i), i);
+                else table.contains(prefix + to_string(i - 1));
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return (double)opsPerThread * nthreads / elapsed.count();
+}
+
+int main() {
+    int maxThreads = (int)thread::hardware_concurrency();
+    if (maxThreads < 4) maxThreads = 4;
+
+    cout << "hilos | mutex global (ops/s) | stripes (ops/s) | speedup\n";
+    for (int n = 1; n <= maxThreads; n *= 2) {
+        GlobalLockHash global;
+        ConcurrentChainHash<string, int> striped;
+        double a = run(global, n);
+        double b = run(striped, n);
+        cout << n << " | " << (long long)a << " | " << (long long)b << " | " << b / a << "x\n";
+    }
+    return 0;
+}
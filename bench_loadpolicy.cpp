@@ -0,0 +1,143 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include "chainhash.h"
+
+using namespace std;
+
+const int lookupRounds = 20;
+
+vector<pair<string, string>> loadCSV(string file);
+
+// inserta todo, busca cada clave (hits) y otras tantas ausentes (misses). Se
+// compila sin CHAINHASH_STATS para que los tiempos no incluyan contadores: los
+// sondeos salen despues de la forma de la tabla (un hit en la posicion j de
+// su cadena visita j nodos, un miss recorre toda la cadena de su bucket)
+template<typename Policy, typename TK>
+void run(const string& policyName, const vector<pair<TK, TK>>& data, const vector<TK>& absent) {
+    ChainHash<TK, TK, ChainHashSeededHash<TK>, std::equal_to<>, ModIndexing, Policy> hash;
+
+    auto start = chrono::steady_clock::now();
+    for (const auto& p : data) hash.set(p.first, p.second);
+    chrono::duration<double> build = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+    size_t found = 0;
+    for (int r = 0; r < lookupRounds; r++) {
+        for (const auto& p : data) found += hash.contains(p.first);
+        for (const auto& k : absent) found += hash.contains(k);
+    }
+    chrono::duration<double> lookup = chrono::steady_clock::now() - start;
+    double lookups = (double)lookupRounds * (data.size() + absent.size());
+
+    int longest = 0;
+    long long hitProbes = 0;
+    for (int i = 0; i < hash.bucket_count(); i++) {
+        long long size = hash.bucket_size(i);
+        if (size > longest) longest = (int)size;
+        hitProbes += size * (size + 1) / 2;
+    }
+    long long missProbes = 0;
+    for (const auto& k : absent) missProbes += hash.bucket_size(hash.bucket(k));
+
+    cout << policyName << " | " << hash.bucket_count()
+         << " | " << (double)hash.size() / hash.bucket_count()
+         << " | " << longest
+         << " | " << (double)hitProbes / hash.size()
+         << " | " << (absent.empty() ? 0 : (double)missProbes / absent.size())
+         << " | " << lookup.count() * 1e9 / lookups
+         << " | " << build.count() * 1e3
+         << " | " << hash.memory_bytes() / 1024 << " KiB"
+         << (found == lookupRounds * data.size() ? "" : " (ERROR)") << "\n";
+}
+
+template<typename TK>
+void compare(const string& title, const vector<pair<TK, TK>>& data, const vector<TK>& absent) {
+    cout << "\n" << title << " (" << data.size() << " claves)\n";
+    cout << "politica | buckets | elementos/bucket | cadena max | sondeos hit | sondeos miss"
+            " | ns/lookup | build ms | memoria\n";
+    run<DefaultRehashPolicy>("BucketFillPolicy<>", data, absent);
+    run<ElementLoadPolicy<>>("ElementLoadPolicy<>", data, absent);
+}
+
+int main() {
+    // smalldata.csv tal cual
+    vector<pair<string, string>> csv = loadCSV("smalldata.csv");
+    vector<string> csvAbsent;
+    for (const auto& p : csv) csvAbsent.push_back(p.first + "_X");
+    compare("smalldata.csv", csv, csvAbsent);
+
+    // claves con la forma de smalldata.csv (PRODnnnnnn;Categoria), en volumen
+    vector<pair<string, string>> products;
+    vector<string> productsAbsent;
+    for (int i = 0; i < 200000; i++) {
+        string code = to_string(i);
+        products.push_back({"PROD" + string(6 - code.size(), '0') + code, csv[i % csv.size()].second});
+        productsAbsent.push_back("ITEM" + code);
+    }
+    compare("sintetico PRODnnnnnn", products, productsAbsent);
+
+    // enteros aleatorios
+    mt19937 rng(42);
+    vector<pair<int, int>> randomInts;
+    vector<int> randomAbsent;
+    for (int i = 0; i < 200000; i++) randomInts.push_back({(int)(rng() >> 1), i});
+    for (int i = 0; i < 200000; i++) randomAbsent.push_back(-(int)(rng() >> 2) - 1);
+    compare("sintetico enteros aleatorios", randomInts, randomAbsent);
+
+    // enteros consecutivos (con std::hash sin mezclar serian un elemento por bucket)
+    vector<pair<int, int>> sequential;
+    vector<int> sequentialAbsent;
+    for (int i = 0; i < 200000; i++) sequential.push_back({i, i});
+    for (int i = 0; i < 200000; i++) sequentialAbsent.push_back(-i - 1);
+    compare("sintetico enteros consecutivos", sequential, sequentialAbsent);
+    return 0;
+}
+
+vector<pair<string, string>> loadCSV(string file)
+{
+    vector<pair<string, string>> data;
+    fstream fin;
+    fin.open(file, ios::in);
+
+    if (!fin.is_open()) {
+        cerr << "Error: No se pudo abrir el archivo " << file << endl;
+        return data;
+    }
+
+    string line;
+    bool firstLine = true;
+
+    while (getline(fin, line)) {
+        if (firstLine) {
+            firstLine = false;
+            continue;
+        }
+
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line.empty()) continue;
+
+        stringstream ss(line);
+        string key, value;
+
+        if (getline(ss, key, ';') && getline(ss, value, ';')) {
+            key.erase(0, key.find_first_not_of(" \t"));
+            key.erase(key.find_last_not_of(" \t") + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t") + 1);
+
+            if (!key.empty() && !value.empty()) {
+                data.push_back({key, value});
+            }
+        }
+    }
+
+    fin.close();
+    return data;
+}
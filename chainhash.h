@@ -4,20 +4,172 @@
 #include <vector>
 #include <functional>
 #include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <cstring>
+#ifdef CHAINHASH_STATS
+#include <chrono>
+#endif
 
 using namespace std;
 
-const int maxColision = 3;
-const float maxFillFactor = 0.8;
+const int minCapacity = 10; // el achicamiento automatico no baja de aqui
+const int batchGroup = 16; // claves por grupo de prefetch en las operaciones *_batch
+const int treeifyThreshold = 8; // largo de cadena degenerada a partir del cual se ordena
+
+// Instrumentacion opcional: compilando con -DCHAINHASH_STATS cada tabla cuenta
+// sondeos, rehashings y memoria, y expone stats(). Sin la macro no queda
+// ningun contador en el codigo generado.
+#ifdef CHAINHASH_STATS
+#define CHAINHASH_STAT(stmt) stmt
+#else
+#define CHAINHASH_STAT(stmt)
+#endif
+
+#ifdef CHAINHASH_STATS
+struct ChainHashStats {
+    vector<int> chain_histogram; // chain_histogram[k] = buckets con k elementos
+    long long hits = 0;          // busquedas exitosas
+    long long hit_probes = 0;    // nodos visitados en busquedas exitosas
+    int max_hit_probes = 0;
+    long long misses = 0;        // busquedas fallidas
+    long long miss_probes = 0;   // nodos visitados en busquedas fallidas
+    int max_miss_probes = 0;
+    int rehashes = 0;            // rehashings (crecer o achicar)
+    double rehash_seconds = 0;   // tiempo acumulado en rehashing
+    size_t memory_bytes = 0;     // arrays de buckets + slabs del pool
+    size_t peak_memory_bytes = 0;
+
+    double avg_hit_probes() const { return hits ? (double)hit_probes / hits : 0; }
+    double avg_miss_probes() const { return misses ? (double)miss_probes / misses : 0; }
+};
+#endif
 
 template<typename TK, typename TV>
 struct ChainHashNode {
     TK key;
     TV value;
+    size_t hashcode; // hash completo de key, se calcula una sola vez al insertar
     ChainHashNode* next;
 
-    ChainHashNode(const TK& k, const TV& v, ChainHashNode* n = nullptr)
-        : key(k), value(v), next(n) {}
+    ChainHashNode(const TK& k, const TV& v, size_t h, ChainHashNode* n = nullptr)
+        : key(k), value(v), hashcode(h), next(n) {}
+
+    // construye key y value directamente en el nodo (value a partir de args)
+    template<typename K, typename... Args>
+    ChainHashNode(std::in_place_t, size_t h, ChainHashNode* n, K&& k, Args&&... args)
+        : key(std::forward<K>(k)), value(std::forward<Args>(args)...), hashcode(h), next(n) {}
+};
+
+// Pool de nodos: reserva bloques (slabs) de nodos contiguos y reutiliza los
+// nodos liberados mediante una free-list. Pedir un nodo es avanzar un puntero
+// y los nodos de una misma tabla quedan cerca en memoria.
+template<typename Node>
+class ChainHashNodePool {
+private:
+    union Slot {
+        Slot* nextFree;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    vector<Slot*> slabs;  // bloques reservados, se liberan todos juntos
+    Slot* freeList;       // nodos devueltos con destroy()
+    Slot* cursor;         // siguiente slot sin usar del ultimo slab
+    Slot* slabEnd;
+    int nextSlabSize;
+    size_t reservedSlots; // slots en todos los slabs
+
+    static const int maxSlabSize = 4096;
+
+public:
+    // firstSlabSize se limita a maxSlabSize: una tabla creada con muchos
+    // buckets no reserva un slab de ese tamanio para su primer nodo
+    ChainHashNodePool(int firstSlabSize = 16)
+        : freeList(nullptr), cursor(nullptr), slabEnd(nullptr),
+          nextSlabSize(firstSlabSize <= 0 ? 16 : (firstSlabSize > maxSlabSize ? maxSlabSize : firstSlabSize)),
+          reservedSlots(0) {}
+
+    ChainHashNodePool(const ChainHashNodePool&) = delete;
+    ChainHashNodePool& operator=(const ChainHashNodePool&) = delete;
+
+    ChainHashNodePool(ChainHashNodePool&& other)
+        : slabs(std::move(other.slabs)), freeList(other.freeList), cursor(other.cursor),
+          slabEnd(other.slabEnd), nextSlabSize(other.nextSlabSize), reservedSlots(other.reservedSlots) {
+        other.slabs.clear();
+        other.freeList = other.cursor = other.slabEnd = nullptr;
+        other.reservedSlots = 0;
+    }
+
+    template<typename... Args>
+    Node* create(Args&&... args){
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        } else {
+            if (cursor == slabEnd) grow();
+            slot = cursor++;
+        }
+        try {
+            return new (slot->storage) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->nextFree = freeList;
+            freeList = slot;
+            throw;
+        }
+    }
+
+    void destroy(Node* node){
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+    // deja n slots libres contiguos en un slab de tamanio exacto (carga masiva);
+    // no cambia el tamanio de los slabs siguientes
+    void reserve(size_t n){
+        if ((size_t)(slabEnd - cursor) >= n) return;
+        addSlab(n);
+    }
+
+    // libera todos los slabs; los nodos vivos ya deben estar destruidos
+    void release(){
+        for (Slot* slab : slabs) delete [] slab;
+        slabs.clear();
+        freeList = cursor = slabEnd = nullptr;
+        reservedSlots = 0;
+    }
+
+    size_t reserved_bytes() const {
+        return reservedSlots * sizeof(Slot);
+    }
+
+    ~ChainHashNodePool(){
+        release();
+    }
+
+private:
+    void grow(){
+        addSlab(nextSlabSize);
+        if (nextSlabSize < maxSlabSize) nextSlabSize *= 2;
+    }
+
+    void addSlab(size_t slots){
+        Slot* slab = new Slot[slots];
+        slabs.push_back(slab);
+        cursor = slab;
+        slabEnd = slab + slots;
+        reservedSlots += slots;
+    }
 };
 
 template<typename TK, typename TV>
@@ -58,152 +210,1049 @@ private:
     Node* current;
 };
 
+// Iterador sobre todos los elementos de la tabla. Salta los buckets vacios con
+// el bitmap de ocupacion: un tzcnt por cada 64 buckets, asi recorrer una tabla
+// dispersa cuesta en proporcion a los buckets ocupados.
 template<typename TK, typename TV>
+class ChainHashIterator {
+public:
+    typedef ChainHashNode<TK, TV> Node;
+
+    ChainHashIterator(Node** array, const uint64_t* occupied, int capacity, int bucket)
+        : array(array), occupied(occupied), capacity(capacity), bucket(bucket), current(nullptr) {
+        this->bucket = nextOccupied(bucket);
+        if (this->bucket < capacity) current = array[this->bucket];
+    }
+
+    Node& operator*() const {
+        return *current;
+    }
+
+    Node* operator->() const {
+        return current;
+    }
+
+    ChainHashIterator& operator++() {
+        current = current->next;
+        if (current == nullptr) {
+            bucket = nextOccupied(bucket + 1);
+            if (bucket < capacity) current = array[bucket];
+        }
+        return *this;
+    }
+
+    ChainHashIterator operator++(int) {
+        ChainHashIterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const ChainHashIterator& other) const {
+        return this->current == other.current;
+    }
+
+    bool operator!=(const ChainHashIterator& other) const {
+        return this->current != other.current;
+    }
+
+private:
+    Node** array;
+    const uint64_t* occupied;
+    int capacity;
+    int bucket;
+    Node* current;
+
+    // primer bucket ocupado con indice >= from, o capacity si no hay
+    int nextOccupied(int from) const {
+        if (from >= capacity) return capacity;
+        int word = from >> 6;
+        int words = (capacity + 63) >> 6;
+        uint64_t bits = occupied[word] & (~0ull << (from & 63));
+        while (bits == 0) {
+            if (++word >= words) return capacity;
+            bits = occupied[word];
+        }
+        return (word << 6) + __builtin_ctzll(bits);
+    }
+};
+
+// Hash sin semilla: std::hash<TK>. Lo usan las variantes que no guardan un
+// hasher por instancia. Para std::string es transparente: acepta string_view o
+// const char* y da el mismo valor que std::hash<string>, asi que se puede
+// buscar sin construir un string temporal.
+template<typename TK>
+struct ChainHashHasher {
+    size_t operator()(const TK& key) const { return std::hash<TK>()(key); }
+};
+
+template<>
+struct ChainHashHasher<std::string> {
+    typedef void is_transparent;
+    size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+};
+
+template<typename T, typename = void>
+struct ChainHashIsTransparent : std::false_type {};
+
+template<typename T>
+struct ChainHashIsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+// true si A y B se pueden comparar con < en ambos sentidos
+template<typename A, typename B, typename = void>
+struct ChainHashIsOrdered : std::false_type {};
+
+template<typename A, typename B>
+struct ChainHashIsOrdered<A, B, std::void_t<decltype(std::declval<const A&>() < std::declval<const B&>()),
+                                            decltype(std::declval<const B&>() < std::declval<const A&>())>>
+    : std::true_type {};
+
+// los bins ordenan y buscan con operator<, que solo es coherente con la
+// igualdad de la tabla si KeyEqual es std::equal_to: un KeyEqual propio (por
+// ejemplo sin distinguir mayusculas) junta claves que operator< separa
+template<typename TK, typename KeyEqual>
+struct ChainHashUsesBins
+    : std::integral_constant<bool, ChainHashIsOrdered<TK, TK>::value &&
+                                   (std::is_same<KeyEqual, std::equal_to<>>::value ||
+                                    std::is_same<KeyEqual, std::equal_to<TK>>::value)> {};
+
+// Semillas de los hashers por defecto: cada tabla toma una distinta de una
+// secuencia que arranca de std::random_device, asi que un conjunto de claves
+// armado para colisionar en una tabla no sirve para otra ni para otra
+// ejecucion. Compilando con -DCHAINHASH_SEED=<n> la secuencia es fija (salidas
+// reproducibles).
+inline uint64_t chainHashMix64(uint64_t x){
+    // finalizador de splitmix64: biyectivo, cada bit de entrada afecta a todos
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t chainHashNextSeed(){
+#ifdef CHAINHASH_SEED
+    static std::atomic<uint64_t> state((uint64_t)(CHAINHASH_SEED));
+#else
+    static std::atomic<uint64_t> state(((uint64_t)std::random_device()() << 32) ^ std::random_device()());
+#endif
+    return chainHashMix64(state.fetch_add(0x9e3779b97f4a7c15ull) + 0x9e3779b97f4a7c15ull);
+}
+
+// Hash por defecto de ChainHash: std::hash<TK> sumado a la semilla y pasado por
+// chainHashMix64. Para enteros y punteros std::hash es la identidad, que con
+// % capacity agrupa claves con el mismo resto (multiplos, direcciones
+// alineadas); el mezclador reparte todos los bits en el indice.
+template<typename TK>
+struct ChainHashSeededHash {
+    uint64_t seed;
+
+    ChainHashSeededHash() : seed(chainHashNextSeed()) {}
+
+    size_t operator()(const TK& key) const {
+        return (size_t)chainHashMix64((uint64_t)std::hash<TK>()(key) + seed);
+    }
+};
+
+// wyhash (Wang Yi, dominio publico) para strings: procesa 16 o 48 bytes por
+// iteracion con multiplicaciones de 64x64->128 bits. Es transparente sobre
+// string_view, igual que ChainHashHasher<string>.
+struct ChainHashWyHash {
+    typedef void is_transparent;
+    uint64_t seed; // ya mezclada con los secretos, como la deja wyhash antes de leer la clave
+
+    ChainHashWyHash() : seed(initialState(chainHashNextSeed())) {}
+
+    size_t operator()(std::string_view key) const {
+        const unsigned char* p = (const unsigned char*)key.data();
+        size_t len = key.size();
+        uint64_t s = seed;
+        uint64_t a, b;
+        if (len <= 16) {
+            if (len >= 4) {
+                a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+                b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+            } else if (len > 0) {
+                a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t see1 = s, see2 = s;
+                do {
+                    s = mix(read8(p) ^ secret1, read8(p + 8) ^ s);
+                    see1 = mix(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+                    see2 = mix(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                s ^= see1 ^ see2;
+            }
+            while (i > 16) {
+                s = mix(read8(p) ^ secret1, read8(p + 8) ^ s);
+                i -= 16;
+                p += 16;
+            }
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+        }
+        a ^= secret1;
+        b ^= s;
+        multiply(a, b);
+        return (size_t)mix(a ^ secret0 ^ len, b ^ secret1);
+    }
+
+private:
+    static constexpr uint64_t secret0 = 0x2d358dccaa6c78a5ull;
+    static constexpr uint64_t secret1 = 0x8bb84b93962eacc9ull;
+    static constexpr uint64_t secret2 = 0x4b33a62ed433d4a3ull;
+    static constexpr uint64_t secret3 = 0x4d5a2da51de1aa47ull;
+
+    // solo depende de la semilla: se calcula una vez por hasher, no por clave
+    static uint64_t initialState(uint64_t raw){
+        return raw ^ mix(raw ^ secret0, secret1);
+    }
+
+    static void multiply(uint64_t& a, uint64_t& b){
+        unsigned __int128 r = (unsigned __int128)a * b;
+        a = (uint64_t)r;
+        b = (uint64_t)(r >> 64);
+    }
+
+    static uint64_t mix(uint64_t a, uint64_t b){
+        multiply(a, b);
+        return a ^ b;
+    }
+
+    static uint64_t read8(const unsigned char* p){
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+    }
+
+    static uint64_t read4(const unsigned char* p){
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+};
+
+template<>
+struct ChainHashSeededHash<std::string> : ChainHashWyHash {};
+
+template<>
+struct ChainHashSeededHash<std::string_view> : ChainHashWyHash {};
+
+// Politicas de indexacion: deciden que capacidades son validas y como se pasa
+// de un hashcode a un indice de bucket.
+//   fit(n)      menor capacidad valida >= n
+//   grow(cap)   capacidad siguiente al crecer
+//   resize(cap) se llama cada vez que cambia la capacidad del array
+//   index(h)    bucket del hashcode h con la capacidad actual
+
+// politica original: cualquier capacidad, crece a 2n+1 e indexa con %
+struct ModIndexing {
+    size_t cap = 1;
+
+    int fit(int n) const { return n > 0 ? n : 1; }
+    int grow(int c) const { return c * 2 + 1; }
+    void resize(int c) { cap = (size_t)c; }
+    size_t index(size_t hashcode) const { return hashcode % cap; }
+};
+
+// capacidades potencia de 2 con hashing de Fibonacci: se multiplica por 2^64/phi
+// y se toman los log2(cap) bits altos, sin division en el camino caliente
+struct PowerOfTwoIndexing {
+    int shift = 63; // 64 - log2(cap)
+
+    int fit(int n) const {
+        int c = 2;
+        while (c < n && c < (1 << 30)) c <<= 1;
+        return c;
+    }
+    int grow(int c) const { return c < (1 << 30) ? c * 2 : c; }
+    void resize(int c) {
+        shift = 64;
+        while (c > 1) { c >>= 1; shift--; }
+    }
+    size_t index(size_t hashcode) const {
+        return (size_t)(((uint64_t)hashcode * 11400714819323198485ull) >> shift);
+    }
+};
+
+// capacidades primas (aprox. el doble en cada paso) con modulo rapido de
+// Lemire: el divisor se reemplaza por dos multiplicaciones con una constante
+// precalculada al cambiar de capacidad
+struct PrimeIndexing {
+    uint64_t magic = 0; // ceil(2^64 / prime)
+    uint32_t prime = 1;
+
+    static const uint32_t* primes(int& count) {
+        static const uint32_t table[] = {
+            5, 11, 23, 47, 97, 197, 397, 797, 1597, 3203, 6421, 12853, 25717,
+            51437, 102877, 205759, 411527, 823117, 1646237, 3292489, 6584983,
+            13169977, 26339969, 52679969, 105359939, 210719881, 421439783,
+            842879579, 1685759167, 2147483647
+        };
+        count = (int)(sizeof(table) / sizeof(table[0]));
+        return table;
+    }
+
+    int fit(int n) const {
+        int count;
+        const uint32_t* table = primes(count);
+        for (int i = 0; i < count; ++i)
+            if ((int64_t)table[i] >= n) return (int)table[i];
+        return (int)table[count - 1];
+    }
+    int grow(int c) const { return fit(c + 1); }
+    void resize(int c) {
+        prime = (uint32_t)c;
+        magic = UINT64_MAX / prime + 1;
+    }
+    size_t index(size_t hashcode) const {
+        uint32_t folded = (uint32_t)((uint64_t)hashcode ^ ((uint64_t)hashcode >> 32));
+        uint64_t low = magic * folded;
+        return (size_t)(((unsigned __int128)low * prime) >> 64);
+    }
+};
+
+// Politicas de rehashing: los umbrales de crecimiento y achicamiento de una
+// tabla, como constantes de compilacion. Los factores de carga se expresan
+// como fracciones enteras para no dividir en punto flotante en cada set.
+//   maxColision           elementos por bucket antes de crecer
+//   overloaded(...)       el factor de carga supera el maximo: crecer
+//   underloaded(...)      el factor de carga baja del minimo: achicar
+//   capacityFor(n)        buckets para n elementos sin superar el maximo
+// BucketFillPolicy usa el factor de carga original: buckets ocupados / capacidad.
+template<int MaxColision = 3, int MaxFillNum = 4, int MaxFillDen = 5,
+         int MinFillNum = 1, int MinFillDen = 5>
+struct BucketFillPolicy {
+    static constexpr int maxColision = MaxColision;
+
+    static constexpr bool overloaded(int nsize, int usedBuckets, int capacity){
+        (void)nsize;
+        return (long long)usedBuckets * MaxFillDen > (long long)capacity * MaxFillNum;
+    }
+
+    static constexpr bool underloaded(int nsize, int usedBuckets, int capacity){
+        (void)nsize;
+        return (long long)usedBuckets * MinFillDen < (long long)capacity * MinFillNum;
+    }
+
+    // en el peor caso cada elemento ocupa su propio bucket
+    static constexpr int capacityFor(size_t n){
+        return (int)(n * MaxFillDen / MaxFillNum) + 1;
+    }
+};
+
+// Factor de carga por elementos: nsize / capacidad, como std::unordered_map.
+// El crecimiento ya no depende de como se repartan las claves en los buckets,
+// asi que maxColision queda como red de seguridad para cadenas anomalas y no
+// como el disparador habitual.
+template<int MaxColision = 8, int MaxLoadNum = 1, int MaxLoadDen = 1,
+         int MinLoadNum = 1, int MinLoadDen = 4>
+struct ElementLoadPolicy {
+    static constexpr int maxColision = MaxColision;
+
+    static constexpr bool overloaded(int nsize, int usedBuckets, int capacity){
+        (void)usedBuckets;
+        return (long long)nsize * MaxLoadDen > (long long)capacity * MaxLoadNum;
+    }
+
+    static constexpr bool underloaded(int nsize, int usedBuckets, int capacity){
+        (void)usedBuckets;
+        return (long long)nsize * MinLoadDen < (long long)capacity * MinLoadNum;
+    }
+
+    static constexpr int capacityFor(size_t n){
+        return (int)(n * MaxLoadDen / MaxLoadNum) + 1;
+    }
+};
+
+typedef BucketFillPolicy<> DefaultRehashPolicy;        // maxColision = 3, maxFillFactor = 0.8
+typedef BucketFillPolicy<6, 9, 10> WriteHeavyRehashPolicy; // crece menos seguido
+typedef BucketFillPolicy<2, 1, 2> ReadHeavyRehashPolicy;   // cadenas mas cortas
+
+// Hash y KeyEqual van despues de TV, como en std::unordered_map. Hash debe
+// devolver el mismo valor para claves que KeyEqual considera iguales; si
+// declara is_transparent se habilitan las busquedas con otros tipos de clave.
+template<typename TK, typename TV, typename Hash = ChainHashSeededHash<TK>,
+         typename KeyEqual = std::equal_to<>, typename Indexing = ModIndexing,
+         typename Rehash = DefaultRehashPolicy>
 class ChainHash
 {
 private:
     typedef ChainHashNode<TK, TV> Node;
     typedef ChainHashListIterator<TK, TV> Iterator;
+    typedef ChainHashIterator<TK, TV> TableIterator;
+
+    // habilita las sobrecargas de busqueda con claves de otro tipo (string_view,
+    // const char*) solo si el hash es transparente
+    template<typename K>
+    using IfTransparent = typename std::enable_if<
+        ChainHashIsTransparent<Hash>::value && !std::is_same<K, TK>::value, int>::type;
 
     Node** array;  // array de punteros a Node
     int nsize; // total de elementos <key:value> insertados
     int capacity; // tamanio del array
     int *bucket_sizes; // guarda la cantidad de elementos en cada bucket
     int usedBuckets; // cantidad de buckets ocupados (con al menos un elemento)
+    int minimumCapacity; // pedida al construir o con reserve(); el achicamiento automatico no baja de aqui
+    int reservedSize; // elementos pedidos con reserve() o la carga masiva; hasta ahi las colisiones no hacen crecer
+    uint64_t* occupied; // bitmap de buckets ocupados, un bit por bucket
+    ChainHashNodePool<Node> pool; // de aqui salen todos los nodos de la tabla
+    Indexing indexing; // hashcode -> indice de bucket para la capacidad actual
+    Hash hasher;       // con su propia semilla en los hashers por defecto
+    KeyEqual keyEqual;
+    // Cadenas degeneradas: si mas de maxColision claves comparten el hashcode
+    // completo, crecer no las separa y solo provoca rehashings en cadena. Esos
+    // buckets no hacen crecer la tabla y, desde treeifyThreshold nodos y si TK
+    // tiene operator< y KeyEqual es std::equal_to, bins[i] guarda ademas sus nodos ordenados por
+    // (hashcode, key) para buscar y borrar en O(log n), como los bins arbol de
+    // HashMap en Java 8. La cadena de esos buckets se mantiene enlazada en el
+    // mismo orden, asi que el recorrido y el rehashing no cambian. bins es
+    // nullptr hasta la primera cadena degenerada.
+    vector<Node*>** bins;
+    size_t binHeapBytes; // vectores de los bins y sus buffers, para memoryBytes()
+    static constexpr bool usesBins = ChainHashUsesBins<TK, KeyEqual>::value;
+#ifdef CHAINHASH_STATS
+    ChainHashStats counters;
+#endif
 
 public:
-    ChainHash(int initialCapacity = 10){
+    ChainHash(int initialCapacity = 10, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : pool(initialCapacity), hasher(hash), keyEqual(equal), bins(nullptr), binHeapBytes(0){
         if (initialCapacity <= 0) initialCapacity = 10;
-        this->capacity = initialCapacity;
+        this->capacity = indexing.fit(initialCapacity);
+        this->indexing.resize(this->capacity);
         this->array = new Node*[capacity]();
         this->bucket_sizes = new int[capacity]();
+        this->occupied = new uint64_t[bitmapWords(capacity)]();
         this->nsize = 0;
         this->usedBuckets = 0;
+        this->minimumCapacity = this->capacity;
+        this->reservedSize = 0;
     }
 
-    TV get(TK key){
-        size_t hashcode = getHashCode(key);
-        size_t index = hashcode % capacity;
+    // Carga masiva: el array se dimensiona una sola vez para la cantidad final
+    // de elementos y se inserta sin rehashing intermedio. Como con reserve(),
+    // las colisiones no hacen crecer la tabla mientras no haya mas elementos
+    // que filas, asi que algun bucket puede quedar con mas de
+    // Rehash::maxColision elementos.
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    ChainHash(It first, It last) : ChainHash(first, last, (size_t)std::distance(first, last)) {}
 
-        Node* current = this->array[index];
-        while(current != nullptr){
-            if(current->key == key) return current->value;
-            current = current->next;
+    // count = cantidad de filas: todos los nodos salen de un solo slab
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    ChainHash(It first, It last, size_t count) : ChainHash(Rehash::capacityFor(count)){
+        pool.reserve(count);
+        for (; first != last; ++first) {
+            const TK& key = first->first;
+            size_t hashcode = getHashCode(key);
+            size_t index = indexing.index(hashcode);
+            Node* current = findNode(key, hashcode, index);
+            if (current != nullptr) current->value = first->second;
+            else link(pool.create(key, first->second, hashcode), index, false);
         }
-        throw std::out_of_range("Key no encontrado");
+        this->reservedSize = (int)count;
+    }
+
+    ChainHash(const vector<pair<TK, TV>>& items) : ChainHash(items.begin(), items.end()) {}
+
+    // los nodos viven en el pool de la tabla, asi que no se copia; mover deja
+    // a la tabla de origen sin buckets (solo se puede destruir)
+    ChainHash(const ChainHash&) = delete;
+    ChainHash& operator=(const ChainHash&) = delete;
+
+    ChainHash(ChainHash&& other)
+        : array(other.array), nsize(other.nsize), capacity(other.capacity),
+          bucket_sizes(other.bucket_sizes), usedBuckets(other.usedBuckets),
+          minimumCapacity(other.minimumCapacity), reservedSize(other.reservedSize),
+          occupied(other.occupied), pool(std::move(other.pool)), indexing(other.indexing),
+          hasher(other.hasher), keyEqual(other.keyEqual), bins(other.bins),
+          binHeapBytes(other.binHeapBytes) {
+        other.array = nullptr;
+        other.bins = nullptr;
+        other.binHeapBytes = 0;
+        other.bucket_sizes = nullptr;
+        other.occupied = nullptr;
+        other.nsize = other.capacity = other.usedBuckets = 0;
+        CHAINHASH_STAT(this->counters = other.counters);
+    }
+
+    TV get(const TK& key){ return getImpl(key); }
+
+    template<typename K, IfTransparent<K> = 0>
+    TV get(const K& key){ return getImpl(key); }
+
+    // puntero al valor de key o nullptr si no existe: sin copias ni excepciones
+    TV* find(const TK& key){ return findImpl(key); }
+
+    template<typename K, IfTransparent<K> = 0>
+    TV* find(const K& key){ return findImpl(key); }
+
+    // referencia opcional al valor de key
+    std::optional<std::reference_wrapper<TV>> try_get(const TK& key){ return tryGetImpl(key); }
+
+    template<typename K, IfTransparent<K> = 0>
+    std::optional<std::reference_wrapper<TV>> try_get(const K& key){ return tryGetImpl(key); }
+
+    // valor de key, insertando TV() si no existia (un solo sondeo)
+    TV& operator[](const TK& key){
+        return try_emplace(key).first->value;
+    }
+
+    TV& operator[](TK&& key){
+        return try_emplace(std::move(key)).first->value;
     }
 
     int size(){ return this->nsize; }
 
+#ifdef CHAINHASH_STATS
+    // contadores acumulados mas el histograma de largo de cadenas actual
+    ChainHashStats stats(){
+        ChainHashStats result = counters;
+        int longest = 0;
+        for (int i = 0; i < capacity; ++i)
+            if (bucket_sizes[i] > longest) longest = bucket_sizes[i];
+        result.chain_histogram.assign(longest + 1, 0);
+        for (int i = 0; i < capacity; ++i) result.chain_histogram[bucket_sizes[i]]++;
+        result.memory_bytes = memoryBytes();
+        return result;
+    }
+
+    void reset_stats(){
+        counters = ChainHashStats();
+        counters.peak_memory_bytes = memoryBytes();
+    }
+#endif
+
+    // achica el array a la menor capacidad que aloja los elementos actuales
+    // sin superar el factor de carga maximo (puede dejar buckets con mas de
+    // Rehash::maxColision elementos). Descarta la capacidad pedida con el
+    // constructor o reserve(): es lo unico que baja de ella.
+    void shrink_to_fit(){
+        int target = indexing.fit(Rehash::capacityFor(this->nsize));
+        if (target < minCapacity) target = indexing.fit(minCapacity);
+        this->minimumCapacity = target;
+        this->reservedSize = 0;
+        if (target < this->capacity) rehashing(target);
+    }
+
+    // deja el array con capacidad para n elementos sin superar el factor de
+    // carga maximo. capacityFor no cuenta Rehash::maxColision, asi que
+    // mientras la tabla tenga hasta n elementos las colisiones no la hacen
+    // crecer: llenarla hasta n despues de reserve(n) no hace rehashing.
+    void reserve(int n){
+        int needed = indexing.fit(Rehash::capacityFor(n));
+        if (needed > this->minimumCapacity) this->minimumCapacity = needed;
+        if (needed > this->capacity) rehashing(needed);
+        if (n > this->reservedSize) this->reservedSize = n;
+    }
+
     int bucket_count(){ return this->capacity; }
 
+    // bucket en el que esta (o estaria) key, como unordered_map::bucket
+    int bucket(const TK& key){ return (int)indexing.index(getHashCode(key)); }
+
+    // bytes de los arrays de buckets, los slabs del pool y los bins; no
+    // necesita CHAINHASH_STATS
+    size_t memory_bytes(){ return memoryBytes(); }
+
     int bucket_size(int index) {
         if(index < 0 || index >= this->capacity) throw std::out_of_range("Indice de bucket invalido");
         return this->bucket_sizes[index];
     }
 
+    // key y value se reciben por valor y se mueven al nodo: quien llama con
+    // std::move no paga ninguna copia
     void set(TK key, TV value){
         size_t hashcode = getHashCode(key);
-        size_t index = hashcode % capacity;
+        size_t index = indexing.index(hashcode);
 
-        Node* head = array[index];
-        Node* current = head;
-        while(current != nullptr){
-            if(current->key == key){
-                current->value = value;
-                return;
+        Node* current = findNode(key, hashcode, index);
+        if (current != nullptr) {
+            current->value = std::move(value);
+            return;
+        }
+        link(pool.create(std::in_place, hashcode, nullptr, std::move(key), std::move(value)), index);
+    }
+
+    // Construye el elemento en su nodo: key a partir de k y value a partir de
+    // args. Si la clave ya existia no se modifica y se devuelve false.
+    template<typename K, typename... Args>
+    std::pair<Iterator, bool> emplace(K&& k, Args&&... args){
+        Node* node = pool.create(std::in_place, 0, nullptr, std::forward<K>(k), std::forward<Args>(args)...);
+        node->hashcode = getHashCode(node->key);
+        size_t index = indexing.index(node->hashcode);
+
+        Node* current = findNode(node->key, node->hashcode, index);
+        if (current != nullptr) {
+            pool.destroy(node);
+            return std::make_pair(Iterator(current), false);
+        }
+        return std::make_pair(Iterator(link(node, index)), true);
+    }
+
+    // Como emplace, pero busca antes de construir: si la clave ya existe los
+    // args no se tocan.
+    template<typename... Args>
+    std::pair<Iterator, bool> try_emplace(const TK& key, Args&&... args){
+        size_t hashcode = getHashCode(key);
+        size_t index = indexing.index(hashcode);
+
+        Node* current = findNode(key, hashcode, index);
+        if (current != nullptr) return std::make_pair(Iterator(current), false);
+        Node* node = pool.create(std::in_place, hashcode, nullptr, key, std::forward<Args>(args)...);
+        return std::make_pair(Iterator(link(node, index)), true);
+    }
+
+    template<typename... Args>
+    std::pair<Iterator, bool> try_emplace(TK&& key, Args&&... args){
+        size_t hashcode = getHashCode(key);
+        size_t index = indexing.index(hashcode);
+
+        Node* current = findNode(key, hashcode, index);
+        if (current != nullptr) return std::make_pair(Iterator(current), false);
+        Node* node = pool.create(std::in_place, hashcode, nullptr, std::move(key), std::forward<Args>(args)...);
+        return std::make_pair(Iterator(link(node, index)), true);
+    }
+
+    bool remove(const TK& key){ return removeImpl(key); }
+
+    template<typename K, IfTransparent<K> = 0>
+    bool remove(const K& key){ return removeImpl(key); }
+
+    bool contains(const TK& key){ return containsImpl(key); }
+
+    template<typename K, IfTransparent<K> = 0>
+    bool contains(const K& key){ return containsImpl(key); }
+
+    // Operaciones por lotes. Las claves se procesan en grupos de batchGroup:
+    // primero se calculan los hashes y se hace prefetch de los buckets, luego
+    // del primer nodo de cada cadena, y recien entonces se resuelve cada clave,
+    // asi los fallos de cache del grupo se solapan en lugar de esperarse uno por uno.
+
+    // punteros a los valores (nullptr si la clave no existe), como find
+    vector<TV*> get_batch(const vector<TK>& keys){
+        vector<TV*> result(keys.size());
+        size_t hashes[batchGroup], indices[batchGroup];
+        for (size_t start = 0; start < keys.size(); start += batchGroup) {
+            size_t count = prefetchGroup(keys.size() - start, hashes, indices,
+                                         [&](size_t i) -> const TK& { return keys[start + i]; });
+            for (size_t i = 0; i < count; ++i) {
+                Node* node = findNode(keys[start + i], hashes[i], indices[i]);
+                result[start + i] = node != nullptr ? &node->value : nullptr;
             }
-            current = current->next;
         }
+        return result;
+    }
 
-        Node* newNode = new Node(key, value, head);
-        array[index] = newNode;
-        if (bucket_sizes[index] == 0) {
-            usedBuckets++;
+    vector<bool> contains_batch(const vector<TK>& keys){
+        vector<bool> result(keys.size());
+        size_t hashes[batchGroup], indices[batchGroup];
+        for (size_t start = 0; start < keys.size(); start += batchGroup) {
+            size_t count = prefetchGroup(keys.size() - start, hashes, indices,
+                                         [&](size_t i) -> const TK& { return keys[start + i]; });
+            for (size_t i = 0; i < count; ++i)
+                result[start + i] = findNode(keys[start + i], hashes[i], indices[i]) != nullptr;
         }
-        bucket_sizes[index]++;
-        nsize++;
+        return result;
+    }
 
-        if (bucket_sizes[index] > maxColision || fillFactor() > maxFillFactor) {
-            rehashing();
+    void set_batch(const vector<pair<TK, TV>>& items){
+        size_t hashes[batchGroup], indices[batchGroup];
+        for (size_t start = 0; start < items.size(); start += batchGroup) {
+            size_t count = prefetchGroup(items.size() - start, hashes, indices,
+                                         [&](size_t i) -> const TK& { return items[start + i].first; });
+            int groupCapacity = capacity;
+            for (size_t i = 0; i < count; ++i) {
+                const pair<TK, TV>& item = items[start + i];
+                // un rehashing dentro del grupo invalida los indices precalculados
+                size_t index = capacity == groupCapacity ? indices[i] : indexing.index(hashes[i]);
+                Node* current = findNode(item.first, hashes[i], index);
+                if (current != nullptr) current->value = item.second;
+                else link(pool.create(item.first, item.second, hashes[i]), index);
+            }
         }
     }
 
-    bool remove(TK key){
+    Iterator begin(int index) {
+        if(index < 0 || index >= capacity) throw std::out_of_range("Indice de bucket invalido");
+        return Iterator(this->array[index]);
+    };
+    Iterator end(int index) {
+        (void)index;
+        return Iterator(nullptr);
+    };
+
+    // recorrido de toda la tabla, bucket por bucket
+    TableIterator begin() {
+        return TableIterator(this->array, this->occupied, this->capacity, 0);
+    }
+    TableIterator end() {
+        return TableIterator(this->array, this->occupied, this->capacity, this->capacity);
+    }
+
+private:
+    template<typename K>
+    TV getImpl(const K& key){
+        size_t hashcode = getHashCode(key);
+        Node* node = findNode(key, hashcode, indexing.index(hashcode));
+        if (node == nullptr) throw std::out_of_range("Key no encontrado");
+        return node->value;
+    }
+
+    template<typename K>
+    TV* findImpl(const K& key){
         size_t hashcode = getHashCode(key);
-        size_t index = hashcode % capacity;
+        Node* node = findNode(key, hashcode, indexing.index(hashcode));
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    template<typename K>
+    std::optional<std::reference_wrapper<TV>> tryGetImpl(const K& key){
+        TV* value = findImpl(key);
+        if (value == nullptr) return std::nullopt;
+        return std::ref(*value);
+    }
+
+    template<typename K>
+    bool removeImpl(const K& key){
+        size_t hashcode = getHashCode(key);
+        size_t index = indexing.index(hashcode);
+
+        Node* current = unlink(key, hashcode, index);
+        if(current == nullptr) return false;
+
+        nsize--;
+        bucket_sizes[index]--;
+        if(bucket_sizes[index] == 0){
+            usedBuckets--;
+            occupied[index >> 6] &= ~(1ull << (index & 63));
+        }
+        // por debajo de treeifyThreshold / 2 el bucket vuelve a ser solo cadena
+        if(bins != nullptr && bins[index] != nullptr && bucket_sizes[index] < treeifyThreshold / 2){
+            binHeapBytes -= sizeof(vector<Node*>) + bins[index]->capacity() * sizeof(Node*);
+            delete bins[index];
+            bins[index] = nullptr;
+        }
+        pool.destroy(current);
+        if(Rehash::underloaded(nsize, usedBuckets, capacity)){
+            shrink();
+        }
+        return true;
+    }
+
+    // desengancha de su bucket (y de su bin) el nodo de key; nullptr si no esta
+    template<typename K>
+    Node* unlink(const K& key, size_t hashcode, size_t index){
+        if constexpr (usesBins && ChainHashIsOrdered<TK, K>::value) {
+            if (bins != nullptr && bins[index] != nullptr) {
+                // la cadena de un bucket con bin sigue el orden del bin, asi
+                // que el anterior en la cadena es el anterior en el bin
+                vector<Node*>& bin = *bins[index];
+                int probes = 0;
+                size_t pos = binPosition(bin, key, hashcode, probes);
+                if (pos == bin.size() || bin[pos]->hashcode != hashcode || !keyEqual(bin[pos]->key, key)) {
+                    CHAINHASH_STAT(recordLookup(false, probes));
+                    return nullptr;
+                }
+                CHAINHASH_STAT(recordLookup(true, probes));
+                Node* node = bin[pos];
+                if (pos == 0) array[index] = node->next;
+                else bin[pos - 1]->next = node->next;
+                bin.erase(bin.begin() + pos);
+                return node;
+            }
+        }
 
         Node* current = array[index];
         Node* prev = nullptr;
+        CHAINHASH_STAT(int probes = 0);
         while(current != nullptr){
-            if(current->key == key){
+            CHAINHASH_STAT(probes++);
+            if(current->hashcode == hashcode && keyEqual(current->key, key)){
+                CHAINHASH_STAT(recordLookup(true, probes));
                 if(prev == nullptr){
                     array[index] = current->next;
                 } else {
                     prev->next = current->next;
                 }
-                delete current;
-                nsize--;
-                bucket_sizes[index]--;
-                if(bucket_sizes[index] == 0){
-                    usedBuckets--;
+                if(bins != nullptr && bins[index] != nullptr){
+                    vector<Node*>& bin = *bins[index];
+                    bin.erase(std::find(bin.begin(), bin.end(), current));
                 }
-                return true;
+                return current;
             }
             prev = current;
             current = current->next;
         }
-        return false;
+        CHAINHASH_STAT(recordLookup(false, probes));
+        return nullptr;
     }
 
-    bool contains(TK key){
+    template<typename K>
+    bool containsImpl(const K& key){
         size_t hashcode = getHashCode(key);
-        size_t index = hashcode % capacity;
+        return findNode(key, hashcode, indexing.index(hashcode)) != nullptr;
+    }
 
+    // calcula hash e indice de hasta batchGroup claves y hace prefetch de sus
+    // buckets y del primer nodo de cada uno; devuelve cuantas claves tomo
+    template<typename KeyAt>
+    size_t prefetchGroup(size_t remaining, size_t* hashes, size_t* indices, KeyAt keyAt){
+        size_t count = remaining < (size_t)batchGroup ? remaining : (size_t)batchGroup;
+        for (size_t i = 0; i < count; ++i) {
+            hashes[i] = getHashCode(keyAt(i));
+            indices[i] = indexing.index(hashes[i]);
+            __builtin_prefetch(&array[indices[i]]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Node* head = array[indices[i]];
+            if (head != nullptr) __builtin_prefetch(head);
+        }
+        return count;
+    }
+
+    template<typename K>
+    size_t getHashCode(const K& key){
+        return hasher(key);
+    }
+
+    template<typename K>
+    Node* findNode(const K& key, size_t hashcode, size_t index){
+        if constexpr (usesBins && ChainHashIsOrdered<TK, K>::value) {
+            if (bins != nullptr && bins[index] != nullptr) return findInBin(*bins[index], key, hashcode);
+        }
         Node* current = array[index];
+        CHAINHASH_STAT(int probes = 0);
         while(current != nullptr){
-            if(current->key == key) return true;
+            CHAINHASH_STAT(probes++);
+            if(current->hashcode == hashcode && keyEqual(current->key, key)){
+                CHAINHASH_STAT(recordLookup(true, probes));
+                return current;
+            }
             current = current->next;
         }
+        CHAINHASH_STAT(recordLookup(false, probes));
+        return nullptr;
+    }
+
+    // primera posicion del bin cuyo (hashcode, key) no es menor que el buscado
+    template<typename K>
+    size_t binPosition(const vector<Node*>& bin, const K& key, size_t hashcode, int& probes){
+        size_t lo = 0, hi = bin.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            const Node* node = bin[mid];
+            probes++;
+            if (node->hashcode < hashcode || (node->hashcode == hashcode && node->key < key)) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    template<typename K>
+    Node* findInBin(const vector<Node*>& bin, const K& key, size_t hashcode){
+        int probes = 0;
+        size_t pos = binPosition(bin, key, hashcode, probes);
+        if (pos < bin.size() && bin[pos]->hashcode == hashcode && keyEqual(bin[pos]->key, key)) {
+            CHAINHASH_STAT(recordLookup(true, probes));
+            return bin[pos];
+        }
+        CHAINHASH_STAT(recordLookup(false, probes));
+        return nullptr;
+    }
+
+    // true si mas de maxColision nodos del bucket tienen el hashcode de node
+    bool degenerate(Node* node, size_t index){
+        if constexpr (usesBins) {
+            if (bins != nullptr && bins[index] != nullptr) {
+                // el bin esta ordenado por hashcode: los iguales son contiguos
+                const vector<Node*>& bin = *bins[index];
+                auto first = std::lower_bound(bin.begin(), bin.end(), node->hashcode,
+                    [](const Node* a, size_t h) { return a->hashcode < h; });
+                auto last = std::upper_bound(first, bin.end(), node->hashcode,
+                    [](size_t h, const Node* a) { return h < a->hashcode; });
+                return last - first > Rehash::maxColision;
+            }
+        }
+        int same = 0;
+        for (Node* current = array[index]; current != nullptr; current = current->next)
+            if (current->hashcode == node->hashcode && ++same > Rehash::maxColision) return true;
         return false;
     }
 
-    Iterator begin(int index) {
-        if(index < 0 || index >= capacity) throw std::out_of_range("Indice de bucket invalido");
-        return Iterator(this->array[index]);
-    };
-    Iterator end(int index) {
-        (void)index;
-        return Iterator(nullptr);
-    };
+    // true si algun hashcode se repite en mas de maxColision nodos del bucket
+    bool degenerateBucket(int index){
+        vector<size_t> hashes;
+        hashes.reserve(bucket_sizes[index]);
+        for (Node* current = array[index]; current != nullptr; current = current->next)
+            hashes.push_back(current->hashcode);
+        std::sort(hashes.begin(), hashes.end());
+        size_t run = 1;
+        for (size_t i = 1; i < hashes.size(); ++i) {
+            run = hashes[i] == hashes[i - 1] ? run + 1 : 1;
+            if (run > (size_t)Rehash::maxColision) return true;
+        }
+        return false;
+    }
 
-private:
-    double fillFactor(){
-        return (double)this->usedBuckets / (double)this->capacity;
+    // arma el bin ordenado del bucket index (solo si usesBins)
+    void treeify(size_t index){
+        if constexpr (usesBins) {
+            if (bins == nullptr) bins = new vector<Node*>*[capacity]();
+            vector<Node*>* bin = new vector<Node*>();
+            bin->reserve(bucket_sizes[index]);
+            for (Node* current = array[index]; current != nullptr; current = current->next)
+                bin->push_back(current);
+            std::sort(bin->begin(), bin->end(), [](const Node* a, const Node* b) {
+                return a->hashcode < b->hashcode || (a->hashcode == b->hashcode && a->key < b->key);
+            });
+            // la cadena se reenlaza en el mismo orden
+            for (size_t i = 0; i + 1 < bin->size(); ++i) (*bin)[i]->next = (*bin)[i + 1];
+            bin->back()->next = nullptr;
+            array[index] = bin->front();
+            bins[index] = bin;
+            binHeapBytes += sizeof(vector<Node*>) + bin->capacity() * sizeof(Node*);
+        }
+    }
+
+    // enlaza node en su lugar de la cadena ordenada y del bin
+    void addToBin(Node* node, size_t index){
+        if constexpr (usesBins) {
+            vector<Node*>& bin = *bins[index];
+            int probes = 0;
+            size_t pos = binPosition(bin, node->key, node->hashcode, probes);
+            node->next = pos < bin.size() ? bin[pos] : nullptr;
+            if (pos == 0) array[index] = node;
+            else bin[pos - 1]->next = node;
+            size_t oldCapacity = bin.capacity();
+            bin.insert(bin.begin() + pos, node);
+            binHeapBytes += (bin.capacity() - oldCapacity) * sizeof(Node*);
+        }
+    }
+
+    void freeBins(int cap){
+        if (bins == nullptr) return;
+        for (int i = 0; i < cap; ++i) delete bins[i];
+        delete [] bins;
+        bins = nullptr;
+        binHeapBytes = 0;
+    }
+
+    size_t memoryBytes(){
+        return (size_t)capacity * (sizeof(Node*) + sizeof(int))
+             + (size_t)bitmapWords(capacity) * sizeof(uint64_t)
+             + pool.reserved_bytes()
+             + binBytes();
     }
 
-    size_t getHashCode(TK key){
-        std::hash<TK> ptr_hash;
-        return ptr_hash(key);
+    // se llama en cada insercion con CHAINHASH_STATS: no recorre los bins
+    size_t binBytes(){
+        if (bins == nullptr) return 0;
+        return (size_t)capacity * sizeof(vector<Node*>*) + binHeapBytes;
+    }
+
+#ifdef CHAINHASH_STATS
+    void recordLookup(bool hit, int probes){
+        if (hit) {
+            counters.hits++;
+            counters.hit_probes += probes;
+            if (probes > counters.max_hit_probes) counters.max_hit_probes = probes;
+        } else {
+            counters.misses++;
+            counters.miss_probes += probes;
+            if (probes > counters.max_miss_probes) counters.max_miss_probes = probes;
+        }
+    }
+
+    void updatePeakMemory(){
+        size_t bytes = memoryBytes();
+        if (bytes > counters.peak_memory_bytes) counters.peak_memory_bytes = bytes;
+    }
+#endif
+
+    // enlaza un nodo nuevo al inicio de su bucket (o en su lugar, si el bucket
+    // tiene bin) y crece si hace falta; el rehashing no mueve nodos, asi que el
+    // puntero devuelto sigue valido
+    Node* link(Node* node, size_t index, bool checkGrowth = true){
+        bool binned = bins != nullptr && bins[index] != nullptr;
+        if (binned) {
+            addToBin(node, index);
+        } else {
+            node->next = array[index];
+            array[index] = node;
+        }
+        if (bucket_sizes[index] == 0) {
+            usedBuckets++;
+            occupied[index >> 6] |= 1ull << (index & 63);
+        }
+        bucket_sizes[index]++;
+        nsize++;
+
+        // un bucket con bin tiene nodos degenerados, pero puede tener otros:
+        // un nodo nuevo que no comparte hashcode con mas de maxColision sigue
+        // haciendo crecer la tabla
+        bool grow = checkGrowth && Rehash::overloaded(nsize, usedBuckets, capacity);
+        if (bucket_sizes[index] > Rehash::maxColision) {
+            bool reserved = this->nsize <= this->reservedSize;
+            if (!degenerate(node, index)) grow = grow || (checkGrowth && !reserved);
+            else if (!binned && bucket_sizes[index] >= treeifyThreshold) treeify(index);
+        }
+        CHAINHASH_STAT(updatePeakMemory());
+
+        if (grow) rehashing();
+        return node;
+    }
+
+    static int bitmapWords(int cap){
+        return (cap + 63) / 64;
+    }
+
+    // Achicamiento automatico con histeresis. Rehash::underloaded es solo el
+    // filtro previo; el disparo y el destino se miden con la misma cantidad,
+    // los elementos: el destino es el doble de lo que pide capacityFor(nsize)
+    // y solo se achica si la capacidad actual es mas del doble del destino.
+    // Asi cada achicamiento exige que nsize vuelva a bajar a la mitad, aunque
+    // las claves compartan buckets (usedBuckets mucho menor que nsize). Nunca
+    // baja de minCapacity ni de la capacidad pedida (minimumCapacity).
+    void shrink(){
+        int target = indexing.fit(Rehash::capacityFor(this->nsize) * 2);
+        if (target < minCapacity) target = indexing.fit(minCapacity);
+        if (target < this->minimumCapacity) target = this->minimumCapacity;
+        if ((long long)this->capacity > 2LL * target) rehashing(target);
     }
 
     void rehashing(){
+        int newCap = indexing.grow(this->capacity);
+        if (newCap <= this->capacity) return; // ya no se puede crecer mas
+        rehashing(newCap);
+    }
+
+    // redistribuye todos los nodos en un array de newCap buckets
+    void rehashing(int newCap){
+        CHAINHASH_STAT(auto start = std::chrono::steady_clock::now());
         int oldCap = this->capacity;
-        int newCap = oldCap * 2 + 1;
-        if (newCap <= oldCap) newCap = oldCap + 1; // guard
+        indexing.resize(newCap);
         Node** newArray = new Node*[newCap]();
         int* new_bucket_sizes = new int[newCap]();
+        uint64_t* newOccupied = new uint64_t[bitmapWords(newCap)]();
         int newUsedBuckets = 0;
 
         for(int i = 0; i < oldCap; ++i){
             Node* node = array[i];
             while(node != nullptr){
                 Node* nextNode = node->next;
-                size_t h = getHashCode(node->key);
-                size_t idx = h % newCap;
+                size_t idx = indexing.index(node->hashcode);
                 node->next = newArray[idx];
                 newArray[idx] = node;
-                if (new_bucket_sizes[idx] == 0) newUsedBuckets++;
+                if (new_bucket_sizes[idx] == 0) {
+                    newUsedBuckets++;
+                    newOccupied[idx >> 6] |= 1ull << (idx & 63);
+                }
                 new_bucket_sizes[idx]++;
 
                 node = nextNode;
@@ -212,24 +1261,48 @@ private:
 
         delete [] this->array;
         delete [] this->bucket_sizes;
+        delete [] this->occupied;
+        freeBins(oldCap);
 
         this->array = newArray;
         this->bucket_sizes = new_bucket_sizes;
+        this->occupied = newOccupied;
         this->capacity = newCap;
         this->usedBuckets = newUsedBuckets;
+
+        // los bins se rearman sobre los buckets nuevos, solo en los que siguen
+        // degenerados: una cadena larga de hashcodes distintos (carga masiva,
+        // reserve) se separa creciendo, no con un bin
+        if constexpr (usesBins) {
+            for (int i = 0; i < newCap; ++i)
+                if (bucket_sizes[i] >= treeifyThreshold && bucket_sizes[i] > Rehash::maxColision &&
+                    degenerateBucket(i))
+                    treeify(i);
+        }
+
+#ifdef CHAINHASH_STATS
+        counters.rehashes++;
+        counters.rehash_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        // durante el rehashing conviven el array viejo y el nuevo
+        size_t during = memoryBytes() + (size_t)oldCap * (sizeof(Node*) + sizeof(int))
+                      + (size_t)bitmapWords(oldCap) * sizeof(uint64_t);
+        if (during > counters.peak_memory_bytes) counters.peak_memory_bytes = during;
+#endif
     }
 
 public:
     ~ChainHash(){
         if(this->array){
+            // los nodos se destruyen aqui y su memoria se libera de golpe con el pool
             for(int i = 0; i < this->capacity; ++i){
                 Node* current = this->array[i];
                 while(current != nullptr){
                     Node* next = current->next;
-                    delete current;
+                    current->~Node();
                     current = next;
                 }
             }
+            pool.release();
             delete [] this->array;
             this->array = nullptr;
         }
@@ -237,6 +1310,11 @@ public:
             delete [] this->bucket_sizes;
             this->bucket_sizes = nullptr;
         }
+        if(this->occupied){
+            delete [] this->occupied;
+            this->occupied = nullptr;
+        }
+        freeBins(this->capacity);
     }
 };
 
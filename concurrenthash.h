@@ -0,0 +1,250 @@
+#ifndef CONCURRENTHASH_H
+#define CONCURRENTHASH_H
+
+#include <atomic>
+#include <mutex>
+#include <climits>
+#include "chainhash.h"
+
+const int defaultStripes = 16;
+
+// Variante de ChainHash para varios hilos escritores. Los buckets se reparten
+// en franjas (stripes) con un mutex cada una: el bucket de un hashcode h esta
+// en la franja h % nstripes. Como la capacidad es siempre multiplo de nstripes,
+// la franja de una clave no cambia al crecer, y el rehashing toma todas las
+// franjas en orden para redistribuir los nodos. Cada franja tiene sus propios
+// buckets (el local (h / nstripes) % (capacity / nstripes)) y sus contadores,
+// en memoria separada de las demas: dos hilos en franjas distintas no
+// escriben la misma linea de cache. La capacidad se duplica (sigue
+// siendo potencia de 2 por nstripes), asi que el hashcode pasa por
+// chainHashMix64: con std::hash, que para enteros es la identidad, claves
+// alineadas caerian todas en el mismo bucket y la tabla creceria sin parar.
+template<typename TK, typename TV, typename Rehash = DefaultRehashPolicy>
+class ConcurrentChainHash
+{
+private:
+    typedef ChainHashNode<TK, TV> Node;
+
+    // cada franja en su propia linea de cache; los nodos de sus buckets salen
+    // de su pool. Todo se escribe solo con el mutex tomado; los contadores son
+    // atomicos para que size() y el chequeo de crecimiento los lean sin el
+    struct alignas(64) Stripe {
+        std::mutex lock;
+        ChainHashNodePool<Node> pool;
+        Node** array;                 // capacity / nstripes buckets
+        int* bucket_sizes;            // cantidad de elementos en cada bucket
+        std::atomic<int> nsize;       // elementos en los buckets de la franja
+        std::atomic<int> usedBuckets; // buckets ocupados de la franja
+    };
+
+    int capacity;                 // total de buckets, multiplo de nstripes
+    Stripe* stripes;
+    int nstripes;
+
+public:
+    ConcurrentChainHash(int initialCapacity = 64, int stripeCount = defaultStripes){
+        if (stripeCount <= 0) stripeCount = defaultStripes;
+        if (initialCapacity < stripeCount) initialCapacity = stripeCount;
+        this->nstripes = stripeCount;
+        this->capacity = (initialCapacity + stripeCount - 1) / stripeCount * stripeCount;
+        this->stripes = new Stripe[nstripes];
+        for (int i = 0; i < nstripes; ++i) {
+            stripes[i].array = new Node*[capacity / nstripes]();
+            stripes[i].bucket_sizes = new int[capacity / nstripes]();
+            stripes[i].nsize = 0;
+            stripes[i].usedBuckets = 0;
+        }
+    }
+
+    ConcurrentChainHash(const ConcurrentChainHash&) = delete;
+    ConcurrentChainHash& operator=(const ConcurrentChainHash&) = delete;
+
+    TV get(const TK& key){
+        size_t hashcode = getHashCode(key);
+        Stripe& stripe = stripeOf(hashcode);
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        Node* node = findNode(stripe, key, hashcode, localIndex(hashcode));
+        if (node == nullptr) throw std::out_of_range("Key no encontrado");
+        return node->value;
+    }
+
+    int size(){
+        int total = 0;
+        for (int i = 0; i < nstripes; ++i) total += stripes[i].nsize.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    int bucket_count(){
+        lockAll();
+        int cap = this->capacity;
+        unlockAll();
+        return cap;
+    }
+
+    void set(const TK& key, const TV& value){
+        size_t hashcode = getHashCode(key);
+        Stripe& stripe = stripeOf(hashcode);
+        int observedCap;
+        bool grow;
+        {
+            std::lock_guard<std::mutex> guard(stripe.lock);
+            size_t index = localIndex(hashcode);
+            Node* node = findNode(stripe, key, hashcode, index);
+            if (node != nullptr) {
+                node->value = value;
+                return;
+            }
+
+            stripe.array[index] = stripe.pool.create(key, value, hashcode, stripe.array[index]);
+            if (stripe.bucket_sizes[index] == 0) stripe.usedBuckets.fetch_add(1, std::memory_order_relaxed);
+            stripe.bucket_sizes[index]++;
+            stripe.nsize.fetch_add(1, std::memory_order_relaxed);
+
+            observedCap = capacity;
+            grow = stripe.bucket_sizes[index] > Rehash::maxColision || overloaded(stripe, observedCap);
+        }
+        // el crecimiento se hace fuera del mutex de la franja para poder
+        // tomarlas todas en orden sin deadlock
+        if (grow) rehashing(observedCap);
+    }
+
+    bool remove(const TK& key){
+        size_t hashcode = getHashCode(key);
+        Stripe& stripe = stripeOf(hashcode);
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        size_t index = localIndex(hashcode);
+
+        Node* current = stripe.array[index];
+        Node* prev = nullptr;
+        while (current != nullptr) {
+            if (current->hashcode == hashcode && current->key == key) {
+                if (prev == nullptr) stripe.array[index] = current->next;
+                else prev->next = current->next;
+                stripe.pool.destroy(current);
+                stripe.nsize.fetch_sub(1, std::memory_order_relaxed);
+                stripe.bucket_sizes[index]--;
+                if (stripe.bucket_sizes[index] == 0) stripe.usedBuckets.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            prev = current;
+            current = current->next;
+        }
+        return false;
+    }
+
+    bool contains(const TK& key){
+        size_t hashcode = getHashCode(key);
+        Stripe& stripe = stripeOf(hashcode);
+        std::lock_guard<std::mutex> guard(stripe.lock);
+        return findNode(stripe, key, hashcode, localIndex(hashcode)) != nullptr;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        return (size_t)chainHashMix64((uint64_t)ChainHashHasher<TK>()(key));
+    }
+
+    Stripe& stripeOf(size_t hashcode){
+        return stripes[hashcode % nstripes];
+    }
+
+    // bucket del hashcode dentro de su franja; se lee con el mutex de la franja
+    size_t localIndex(size_t hashcode){
+        return (hashcode / nstripes) % (capacity / nstripes);
+    }
+
+    Node* findNode(Stripe& stripe, const TK& key, size_t hashcode, size_t index){
+        for (Node* current = stripe.array[index]; current != nullptr; current = current->next)
+            if (current->hashcode == hashcode && current->key == key) return current;
+        return nullptr;
+    }
+
+    // Las politicas son lineales en (nsize, usedBuckets): si la tabla supera
+    // el maximo, alguna franja lo supera con sus contadores escalados por
+    // nstripes. Se mira primero la franja propia y solo entonces se suman
+    // todas, asi que un set no lee las lineas de las otras franjas.
+    bool overloaded(Stripe& stripe, int cap){
+        long long local = stripe.nsize.load(std::memory_order_relaxed);
+        long long localUsed = stripe.usedBuckets.load(std::memory_order_relaxed);
+        if (!Rehash::overloaded((int)(local * nstripes), (int)(localUsed * nstripes), cap)) return false;
+        int total = 0, used = 0;
+        for (int i = 0; i < nstripes; ++i) {
+            total += stripes[i].nsize.load(std::memory_order_relaxed);
+            used += stripes[i].usedBuckets.load(std::memory_order_relaxed);
+        }
+        return Rehash::overloaded(total, used, cap);
+    }
+
+    void lockAll(){
+        for (int i = 0; i < nstripes; ++i) stripes[i].lock.lock();
+    }
+
+    void unlockAll(){
+        for (int i = nstripes - 1; i >= 0; --i) stripes[i].lock.unlock();
+    }
+
+    // crece solo si nadie lo hizo desde que se observo expectedCap
+    void rehashing(int expectedCap){
+        lockAll();
+        if (this->capacity != expectedCap) {
+            unlockAll();
+            return;
+        }
+
+        int oldCap = this->capacity;
+        if (oldCap > INT_MAX / 2) { // ya no se puede crecer mas
+            unlockAll();
+            return;
+        }
+        int newCap = oldCap * 2;
+        int newPerStripe = newCap / nstripes;
+
+        // la franja de un nodo no cambia: cada una se redistribuye sola
+        for (int s = 0; s < nstripes; ++s) {
+            Stripe& stripe = stripes[s];
+            Node** newArray = new Node*[newPerStripe]();
+            int* new_bucket_sizes = new int[newPerStripe]();
+            int newUsedBuckets = 0;
+
+            for (int i = 0; i < oldCap / nstripes; ++i) {
+                Node* node = stripe.array[i];
+                while (node != nullptr) {
+                    Node* nextNode = node->next;
+                    size_t idx = (node->hashcode / nstripes) % newPerStripe;
+                    node->next = newArray[idx];
+                    newArray[idx] = node;
+                    if (new_bucket_sizes[idx] == 0) newUsedBuckets++;
+                    new_bucket_sizes[idx]++;
+                    node = nextNode;
+                }
+            }
+
+            delete [] stripe.array;
+            delete [] stripe.bucket_sizes;
+            stripe.array = newArray;
+            stripe.bucket_sizes = new_bucket_sizes;
+            stripe.usedBuckets = newUsedBuckets;
+        }
+        this->capacity = newCap;
+        unlockAll();
+    }
+
+public:
+    ~ConcurrentChainHash(){
+        for (int s = 0; s < nstripes; ++s) {
+            for (int i = 0; i < capacity / nstripes; ++i) {
+                Node* current = stripes[s].array[i];
+                while (current != nullptr) {
+                    Node* next = current->next;
+                    current->~Node();
+                    current = next;
+                }
+            }
+            delete [] stripes[s].array;
+            delete [] stripes[s].bucket_sizes;
+        }
+        delete [] stripes;
+    }
+};
+
+#endif // CONCURRENTHASH_H
@@ -0,0 +1,210 @@
+#ifndef INCREMENTALHASH_H
+#define INCREMENTALHASH_H
+
+#include "chainhash.h"
+
+// cantidad de buckets viejos que migra cada set/get/remove/contains
+const int migrationStep = 4;
+
+// Variante de ChainHash con rehashing incremental: al crecer, el array viejo y
+// el nuevo conviven y cada operacion mueve unos pocos buckets del viejo al
+// nuevo, en lugar de mover todos los nodos dentro de un solo set. Mientras dura
+// la migracion los lookups consultan el bucket viejo (si aun no se migro) y el
+// nuevo.
+template<typename TK, typename TV, typename Rehash = DefaultRehashPolicy>
+class IncrementalChainHash
+{
+private:
+    typedef ChainHashNode<TK, TV> Node;
+
+    Node** array;       // array de punteros a Node (tabla nueva)
+    int nsize;          // total de elementos <key:value> insertados (en ambas tablas)
+    int capacity;       // tamanio del array
+    int *bucket_sizes;  // cantidad de elementos en cada bucket de array
+    int usedBuckets;    // buckets ocupados de array
+
+    Node** oldArray;    // tabla que se esta vaciando (nullptr si no hay migracion)
+    int oldCapacity;
+    int migrated;       // los buckets viejos con indice < migrated ya se movieron
+
+    ChainHashNodePool<Node> pool;
+
+public:
+    IncrementalChainHash(int initialCapacity = 10) : pool(initialCapacity){
+        if (initialCapacity <= 0) initialCapacity = 10;
+        this->capacity = initialCapacity;
+        this->array = new Node*[capacity]();
+        this->bucket_sizes = new int[capacity]();
+        this->nsize = 0;
+        this->usedBuckets = 0;
+        this->oldArray = nullptr;
+        this->oldCapacity = 0;
+        this->migrated = 0;
+    }
+
+    IncrementalChainHash(const IncrementalChainHash&) = delete;
+    IncrementalChainHash& operator=(const IncrementalChainHash&) = delete;
+
+    TV get(TK key){
+        migrateStep();
+        Node* node = findNode(key, getHashCode(key));
+        if (node == nullptr) throw std::out_of_range("Key no encontrado");
+        return node->value;
+    }
+
+    int size(){ return this->nsize; }
+
+    int bucket_count(){ return this->capacity; }
+
+    // true mientras conviven la tabla vieja y la nueva
+    bool rehashing_in_progress(){ return this->oldArray != nullptr; }
+
+    void set(TK key, TV value){
+        migrateStep();
+        size_t hashcode = getHashCode(key);
+        Node* node = findNode(key, hashcode);
+        if (node != nullptr) {
+            node->value = value;
+            return;
+        }
+
+        size_t index = hashcode % capacity;
+        array[index] = pool.create(key, value, hashcode, array[index]);
+        if (bucket_sizes[index] == 0) usedBuckets++;
+        bucket_sizes[index]++;
+        nsize++;
+
+        // durante una migracion no se vuelve a crecer: la tabla nueva tiene el
+        // doble de buckets y la migracion termina en oldCapacity / migrationStep operaciones
+        if (oldArray == nullptr && (bucket_sizes[index] > Rehash::maxColision || Rehash::overloaded(nsize, usedBuckets, capacity))) {
+            startRehashing();
+        }
+    }
+
+    bool remove(TK key){
+        migrateStep();
+        size_t hashcode = getHashCode(key);
+
+        if (oldArray != nullptr) {
+            size_t oldIndex = hashcode % oldCapacity;
+            if ((int)oldIndex >= migrated && unlink(oldArray[oldIndex], key, hashcode)) {
+                nsize--;
+                return true;
+            }
+        }
+
+        size_t index = hashcode % capacity;
+        if (unlink(array[index], key, hashcode)) {
+            nsize--;
+            bucket_sizes[index]--;
+            if (bucket_sizes[index] == 0) usedBuckets--;
+            return true;
+        }
+        return false;
+    }
+
+    bool contains(TK key){
+        migrateStep();
+        return findNode(key, getHashCode(key)) != nullptr;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        std::hash<TK> ptr_hash;
+        return ptr_hash(key);
+    }
+
+    Node* findNode(const TK& key, size_t hashcode){
+        if (oldArray != nullptr) {
+            size_t oldIndex = hashcode % oldCapacity;
+            if ((int)oldIndex >= migrated) {
+                for (Node* current = oldArray[oldIndex]; current != nullptr; current = current->next)
+                    if (current->hashcode == hashcode && current->key == key) return current;
+            }
+        }
+        for (Node* current = array[hashcode % capacity]; current != nullptr; current = current->next)
+            if (current->hashcode == hashcode && current->key == key) return current;
+        return nullptr;
+    }
+
+    bool unlink(Node*& head, const TK& key, size_t hashcode){
+        Node* prev = nullptr;
+        for (Node* current = head; current != nullptr; prev = current, current = current->next) {
+            if (current->hashcode == hashcode && current->key == key) {
+                if (prev == nullptr) head = current->next;
+                else prev->next = current->next;
+                pool.destroy(current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void startRehashing(){
+        int newCap = capacity * 2 + 1;
+        oldArray = array;
+        oldCapacity = capacity;
+        migrated = 0;
+
+        delete [] bucket_sizes;
+        array = new Node*[newCap]();
+        bucket_sizes = new int[newCap]();
+        capacity = newCap;
+        usedBuckets = 0;
+    }
+
+    void migrateStep(){
+        if (oldArray != nullptr) migrateBuckets(migrationStep);
+    }
+
+    void migrateBuckets(int count){
+        int end = migrated + count;
+        if (end > oldCapacity) end = oldCapacity;
+
+        for (; migrated < end; ++migrated) {
+            Node* node = oldArray[migrated];
+            while (node != nullptr) {
+                Node* nextNode = node->next;
+                size_t idx = node->hashcode % capacity;
+                node->next = array[idx];
+                array[idx] = node;
+                if (bucket_sizes[idx] == 0) usedBuckets++;
+                bucket_sizes[idx]++;
+                node = nextNode;
+            }
+            oldArray[migrated] = nullptr;
+        }
+
+        if (migrated == oldCapacity) {
+            delete [] oldArray;
+            oldArray = nullptr;
+            oldCapacity = 0;
+            migrated = 0;
+        }
+    }
+
+    void destroyChains(Node** buckets, int count){
+        for (int i = 0; i < count; ++i) {
+            Node* current = buckets[i];
+            while (current != nullptr) {
+                Node* next = current->next;
+                current->~Node();
+                current = next;
+            }
+        }
+    }
+
+public:
+    ~IncrementalChainHash(){
+        if (oldArray != nullptr) {
+            destroyChains(oldArray, oldCapacity);
+            delete [] oldArray;
+        }
+        destroyChains(array, capacity);
+        pool.release();
+        delete [] array;
+        delete [] bucket_sizes;
+    }
+};
+
+#endif // INCREMENTALHASH_H
@@ -0,0 +1,430 @@
+#ifndef LOCKFREEHASH_H
+#define LOCKFREEHASH_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include "chainhash.h"
+
+// Reclamacion de memoria por epocas (EBR) compartida por todas las tablas
+// lock-free. Un hilo "fija" la epoca global mientras recorre la estructura; un
+// nodo retirado en la epoca e se libera recien cuando la epoca global llega a
+// e + 2, porque para entonces ningun hilo que pudiera verlo sigue fijado.
+class EpochDomain {
+public:
+    static const int maxThreads = 256;
+    static const int collectThreshold = 64;
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    void enter() {
+        ThreadState& ts = local();
+        if (ts.depth++ > 0) return;
+        // estado = (epoca << 1) | 1 mientras el hilo esta fijado; el store es
+        // seq_cst, asi que precede a todas las lecturas del recorrido
+        records[ts.slot].state.store((globalEpoch.load() << 1) | 1);
+    }
+
+    void exit() {
+        ThreadState& ts = local();
+        if (--ts.depth > 0) return;
+        records[ts.slot].state.store(0, std::memory_order_release);
+    }
+
+    // ptr ya no es alcanzable desde la estructura; se libera con deleter
+    void retire(void* ptr, void (*deleter)(void*)) {
+        ThreadState& ts = local();
+        ts.limbo.push_back(Retired{ptr, deleter, globalEpoch.load()});
+        if ((int)ts.limbo.size() >= collectThreshold) {
+            tryAdvance();
+            collect(ts.limbo);
+        }
+    }
+
+    template<typename T>
+    static void deleteAs(void* ptr) {
+        delete static_cast<T*>(ptr);
+    }
+
+    ~EpochDomain() {
+        for (Retired& r : orphans) r.deleter(r.ptr);
+    }
+
+private:
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    struct alignas(64) Record {
+        std::atomic<uint64_t> state{0};
+        std::atomic<bool> inUse{false};
+    };
+
+    // estado por hilo: su registro y los nodos que retiro y aun no libera
+    struct ThreadState {
+        int slot;
+        int depth;
+        std::vector<Retired> limbo;
+
+        ThreadState() : slot(EpochDomain::instance().acquireSlot()), depth(0) {}
+
+        // al terminar el hilo lo pendiente pasa a la lista de huerfanos
+        ~ThreadState() {
+            EpochDomain& domain = EpochDomain::instance();
+            {
+                std::lock_guard<std::mutex> guard(domain.orphanLock);
+                domain.orphans.insert(domain.orphans.end(), limbo.begin(), limbo.end());
+            }
+            domain.records[slot].state.store(0);
+            domain.records[slot].inUse.store(false);
+        }
+    };
+
+    Record records[maxThreads];
+    std::atomic<uint64_t> globalEpoch{0};
+    std::mutex orphanLock;
+    std::vector<Retired> orphans;
+
+    EpochDomain() {}
+
+    static ThreadState& local() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    int acquireSlot() {
+        for (int i = 0; i < maxThreads; ++i) {
+            bool expected = false;
+            if (records[i].inUse.compare_exchange_strong(expected, true)) return i;
+        }
+        throw std::runtime_error("EpochDomain: demasiados hilos");
+    }
+
+    // la epoca avanza solo si todos los hilos fijados ya vieron la actual
+    void tryAdvance() {
+        uint64_t epoch = globalEpoch.load();
+        for (int i = 0; i < maxThreads; ++i) {
+            if (!records[i].inUse.load()) continue;
+            uint64_t state = records[i].state.load();
+            if ((state & 1) && (state >> 1) != epoch) return;
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    void collect(std::vector<Retired>& bag) {
+        uint64_t epoch = globalEpoch.load();
+        size_t kept = 0;
+        for (size_t i = 0; i < bag.size(); ++i) {
+            if (bag[i].epoch + 2 <= epoch) bag[i].deleter(bag[i].ptr);
+            else bag[kept++] = bag[i];
+        }
+        bag.resize(kept);
+
+        std::unique_lock<std::mutex> guard(orphanLock, std::try_to_lock);
+        if (guard.owns_lock() && !orphans.empty()) {
+            kept = 0;
+            for (size_t i = 0; i < orphans.size(); ++i) {
+                if (orphans[i].epoch + 2 <= epoch) orphans[i].deleter(orphans[i].ptr);
+                else orphans[kept++] = orphans[i];
+            }
+            orphans.resize(kept);
+        }
+    }
+};
+
+// fija la epoca durante su alcance
+class EpochGuard {
+public:
+    EpochGuard() { EpochDomain::instance().enter(); }
+    ~EpochGuard() { EpochDomain::instance().exit(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// Nodo de la lista de orden dividido. Igual que ChainHashNode es una lista
+// simple por next, pero hay una sola lista para toda la tabla, ordenada por
+// sokey (el hash con los bits invertidos). El bit bajo de next marca el nodo
+// como borrado logicamente.
+struct SplitListNode {
+    uint64_t sokey; // par: nodo centinela de un bucket, impar: elemento
+    std::atomic<uintptr_t> next;
+
+    explicit SplitListNode(uint64_t k) : sokey(k), next(0) {}
+};
+
+template<typename TK, typename TV>
+struct SplitListEntry : SplitListNode {
+    TK key;
+    std::atomic<TV*> value; // se reemplaza con exchange; el viejo se retira
+    size_t hashcode;
+
+    SplitListEntry(uint64_t k, const TK& key, TV* v, size_t h)
+        : SplitListNode(k), key(key), value(v), hashcode(h) {}
+
+    ~SplitListEntry() { delete value.load(); }
+};
+
+// Tabla hash lock-free con listas de orden dividido (Shalev y Shavit). Todos
+// los elementos viven en una sola lista ordenada por hash invertido y cada
+// bucket es un puntero a un nodo centinela dentro de ella, asi que crecer es
+// solo duplicar la cantidad de buckets: ningun nodo se mueve. contains y get
+// nunca toman locks ni escriben (solo recorren la lista), set y remove usan
+// CAS al estilo Harris-Michael y la memoria se reclama por epocas.
+template<typename TK, typename TV>
+class LockFreeChainHash
+{
+private:
+    typedef SplitListNode Node;
+    typedef SplitListEntry<TK, TV> Entry;
+
+    static const int maxSegments = 48;
+    static const int maxLoad = 2; // elementos por bucket antes de duplicar
+
+    // segmento 0 = buckets [0, 2), segmento k = buckets [2^k, 2^(k+1))
+    std::atomic<std::atomic<Node*>*> segments[maxSegments];
+    std::atomic<size_t> bucketCount; // potencia de 2
+    std::atomic<int> nsize;
+
+public:
+    LockFreeChainHash(int initialCapacity = 16) : bucketCount(2), nsize(0){
+        size_t cap = 2;
+        while (cap < (size_t)initialCapacity) cap <<= 1;
+        this->bucketCount = cap;
+        for (int i = 0; i < maxSegments; ++i) segments[i] = nullptr;
+        bucketSlot(0).store(new Node(0));
+    }
+
+    LockFreeChainHash(const LockFreeChainHash&) = delete;
+    LockFreeChainHash& operator=(const LockFreeChainHash&) = delete;
+
+    TV get(const TK& key){
+        EpochGuard guard;
+        Entry* entry = lookup(key);
+        if (entry == nullptr) throw std::out_of_range("Key no encontrado");
+        return *entry->value.load();
+    }
+
+    int size(){ return this->nsize.load(); }
+
+    int bucket_count(){ return (int)this->bucketCount.load(); }
+
+    void set(const TK& key, const TV& value){
+        EpochGuard guard;
+        size_t hashcode = getHashCode(key);
+        uint64_t sokey = regularKey(hashcode);
+        Node* head = bucketHead(hashcode & (bucketCount.load() - 1));
+
+        Entry* fresh = nullptr;
+        while (true) {
+            std::atomic<uintptr_t>* prevNext;
+            Node* cur;
+            Node* found = search(head, sokey, &key, prevNext, cur);
+            if (found != nullptr) {
+                delete fresh;
+                TV* old = static_cast<Entry*>(found)->value.exchange(new TV(value));
+                EpochDomain::instance().retire(old, &EpochDomain::deleteAs<TV>);
+                return;
+            }
+            if (fresh == nullptr) fresh = new Entry(sokey, key, new TV(value), hashcode);
+            fresh->next.store((uintptr_t)cur);
+            uintptr_t expected = (uintptr_t)cur;
+            if (prevNext->compare_exchange_strong(expected, (uintptr_t)fresh)) break;
+        }
+
+        size_t buckets = bucketCount.load();
+        if (++nsize > (long long)buckets * maxLoad && buckets < ((size_t)1 << (maxSegments - 1))) {
+            bucketCount.compare_exchange_strong(buckets, buckets * 2);
+        }
+    }
+
+    bool remove(const TK& key){
+        EpochGuard guard;
+        size_t hashcode = getHashCode(key);
+        uint64_t sokey = regularKey(hashcode);
+        Node* head = bucketHead(hashcode & (bucketCount.load() - 1));
+
+        while (true) {
+            std::atomic<uintptr_t>* prevNext;
+            Node* cur;
+            Node* found = search(head, sokey, &key, prevNext, cur);
+            if (found == nullptr) return false;
+
+            uintptr_t succ = found->next.load();
+            if (isMarked(succ)) continue; // otro hilo lo esta borrando
+            if (!found->next.compare_exchange_strong(succ, succ | 1)) continue;
+
+            // borrado logico hecho; se intenta desenlazar, y si falla la
+            // siguiente busqueda lo desenlaza y lo retira
+            nsize--;
+            uintptr_t expected = (uintptr_t)found;
+            if (prevNext->compare_exchange_strong(expected, succ)) {
+                EpochDomain::instance().retire(static_cast<Entry*>(found), &EpochDomain::deleteAs<Entry>);
+            } else {
+                search(head, sokey, &key, prevNext, cur);
+            }
+            return true;
+        }
+    }
+
+    bool contains(const TK& key){
+        EpochGuard guard;
+        return lookup(key) != nullptr;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        // se mezcla porque el orden de la lista depende de los bits bajos
+        uint64_t h = (uint64_t)ChainHashHasher<TK>()(key) * 11400714819323198485ull;
+        return (size_t)(h ^ (h >> 29));
+    }
+
+    static uint64_t reverseBits(uint64_t x){
+        x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+        x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((x & 0x0F0F0F0F0F0F0F0Full) << 4);
+        return __builtin_bswap64(x);
+    }
+
+    static uint64_t regularKey(size_t hashcode){ return reverseBits((uint64_t)hashcode | (1ull << 63)); }
+    static uint64_t dummyKey(size_t bucket){ return reverseBits((uint64_t)bucket); }
+
+    static bool isMarked(uintptr_t p){ return (p & 1) != 0; }
+    static Node* pointer(uintptr_t p){ return reinterpret_cast<Node*>(p & ~(uintptr_t)1); }
+
+    bool matches(Node* node, uint64_t sokey, const TK* key){
+        if (node->sokey != sokey) return false;
+        if (key == nullptr) return true; // centinela: basta con la sokey
+        return static_cast<Entry*>(node)->key == *key;
+    }
+
+    // segmento del bucket y posicion dentro de el
+    static int segmentOf(size_t bucket, size_t& offset){
+        offset = bucket;
+        if (bucket < 2) return 0;
+        int seg = 63 - __builtin_clzll(bucket);
+        offset = bucket - ((size_t)1 << seg);
+        return seg;
+    }
+
+    // slot del bucket, reservando su segmento si todavia no existe
+    std::atomic<Node*>& bucketSlot(size_t bucket){
+        size_t offset;
+        int seg = segmentOf(bucket, offset);
+        std::atomic<Node*>* segment = segments[seg].load();
+        if (segment == nullptr) {
+            size_t length = seg == 0 ? 2 : ((size_t)1 << seg);
+            std::atomic<Node*>* fresh = new std::atomic<Node*>[length];
+            for (size_t i = 0; i < length; ++i) fresh[i].store(nullptr);
+            if (segments[seg].compare_exchange_strong(segment, fresh)) segment = fresh;
+            else delete [] fresh;
+        }
+        return segment[offset];
+    }
+
+    // centinela del bucket, creandolo (y a sus padres) si hace falta
+    Node* bucketHead(size_t bucket){
+        std::atomic<Node*>& slot = bucketSlot(bucket);
+        Node* head = slot.load();
+        if (head != nullptr) return head;
+
+        size_t parent = bucket & ~((size_t)1 << (63 - __builtin_clzll(bucket)));
+        Node* parentHead = bucketHead(parent);
+
+        uint64_t sokey = dummyKey(bucket);
+        Node* dummy = new Node(sokey);
+        while (true) {
+            std::atomic<uintptr_t>* prevNext;
+            Node* cur;
+            Node* found = search(parentHead, sokey, nullptr, prevNext, cur);
+            if (found != nullptr) {
+                delete dummy;
+                dummy = found;
+                break;
+            }
+            dummy->next.store((uintptr_t)cur);
+            uintptr_t expected = (uintptr_t)cur;
+            if (prevNext->compare_exchange_strong(expected, (uintptr_t)dummy)) break;
+        }
+        slot.store(dummy);
+        return dummy;
+    }
+
+    // centinela inicializado mas cercano, sin crear nada (camino de lectura):
+    // un segmento sin reservar es un bucket sin inicializar y se sigue por el
+    // padre, asi que contains/get no reservan memoria ni escriben
+    Node* readHead(size_t bucket){
+        while (true) {
+            size_t offset;
+            std::atomic<Node*>* segment = segments[segmentOf(bucket, offset)].load();
+            if (segment != nullptr) {
+                Node* head = segment[offset].load();
+                if (head != nullptr) return head;
+            }
+            bucket &= ~((size_t)1 << (63 - __builtin_clzll(bucket)));
+        }
+    }
+
+    // Busqueda Harris-Michael desde start. Desenlaza y retira los nodos marcados
+    // que encuentra. Deja en prevNext/cur el punto donde insertar sokey: al
+    // inicio de la racha de nodos con esa sokey.
+    Node* search(Node* start, uint64_t sokey, const TK* key,
+                 std::atomic<uintptr_t>*& prevNext, Node*& cur){
+    retry:
+        std::atomic<uintptr_t>* link = &start->next;
+        Node* node = pointer(link->load());
+        prevNext = nullptr;
+        while (true) {
+            if (node == nullptr) {
+                if (prevNext == nullptr) { prevNext = link; cur = nullptr; }
+                return nullptr;
+            }
+            uintptr_t succ = node->next.load();
+            if (isMarked(succ)) {
+                uintptr_t expected = (uintptr_t)node;
+                if (!link->compare_exchange_strong(expected, succ & ~(uintptr_t)1)) goto retry;
+                EpochDomain::instance().retire(static_cast<Entry*>(node), &EpochDomain::deleteAs<Entry>);
+                node = pointer(succ);
+                continue;
+            }
+            if (prevNext == nullptr && node->sokey >= sokey) { prevNext = link; cur = node; }
+            if (node->sokey > sokey) return nullptr;
+            if (matches(node, sokey, key)) return node;
+            link = &node->next;
+            node = pointer(succ);
+        }
+    }
+
+    // recorrido de solo lectura: salta los nodos marcados sin desenlazarlos
+    Entry* lookup(const TK& key){
+        size_t hashcode = getHashCode(key);
+        uint64_t sokey = regularKey(hashcode);
+        Node* node = pointer(readHead(hashcode & (bucketCount.load() - 1))->next.load());
+        while (node != nullptr && node->sokey <= sokey) {
+            uintptr_t succ = node->next.load();
+            if (!isMarked(succ) && matches(node, sokey, &key)) return static_cast<Entry*>(node);
+            node = pointer(succ);
+        }
+        return nullptr;
+    }
+
+public:
+    // se asume que ningun otro hilo usa la tabla mientras se destruye
+    ~LockFreeChainHash(){
+        Node* node = segments[0].load()[0].load();
+        while (node != nullptr) {
+            Node* next = pointer(node->next.load());
+            if (node->sokey & 1) delete static_cast<Entry*>(node);
+            else delete node;
+            node = next;
+        }
+        for (int i = 0; i < maxSegments; ++i) delete [] segments[i].load();
+    }
+};
+
+#endif // LOCKFREEHASH_H
@@ -0,0 +1,218 @@
+#ifndef ORDEREDHASH_H
+#define ORDEREDHASH_H
+
+#include <cstdint>
+#include "chainhash.h"
+
+const uint32_t orderedNil = UINT32_MAX; // fin de cadena / bucket vacio
+
+template<typename TK, typename TV>
+struct OrderedChainHashEntry {
+    TK key;
+    TV value;
+    size_t hashcode;
+    uint32_t next;  // indice del siguiente elemento del bucket en entries
+    bool alive;     // false = tombstone, se compacta en el rehashing
+
+    OrderedChainHashEntry(const TK& k, const TV& v, size_t h, uint32_t n)
+        : key(k), value(v), hashcode(h), next(n), alive(true) {}
+};
+
+// recorre los elementos vivos en orden de insercion
+template<typename TK, typename TV>
+class OrderedChainHashIterator {
+public:
+    typedef OrderedChainHashEntry<TK, TV> Entry;
+
+    OrderedChainHashIterator(Entry* pos, Entry* last) : current(pos), last(last) {
+        skipDead();
+    }
+
+    Entry& operator*() const {
+        return *current;
+    }
+
+    Entry* operator->() const {
+        return current;
+    }
+
+    OrderedChainHashIterator& operator++() {
+        ++current;
+        skipDead();
+        return *this;
+    }
+
+    OrderedChainHashIterator operator++(int) {
+        OrderedChainHashIterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const OrderedChainHashIterator& other) const {
+        return this->current == other.current;
+    }
+
+    bool operator!=(const OrderedChainHashIterator& other) const {
+        return this->current != other.current;
+    }
+
+private:
+    Entry* current;
+    Entry* last;
+
+    void skipDead() {
+        while (current != last && !current->alive) ++current;
+    }
+};
+
+// Variante de ChainHash que conserva el orden de insercion. Los elementos
+// viven contiguos en un vector y los buckets guardan indices de 32 bits a ese
+// vector en lugar de punteros: recorrer en orden es un barrido lineal de
+// memoria. remove deja tombstones que se compactan en el rehashing.
+template<typename TK, typename TV, typename Rehash = DefaultRehashPolicy>
+class OrderedChainHash
+{
+private:
+    typedef OrderedChainHashEntry<TK, TV> Entry;
+    typedef OrderedChainHashIterator<TK, TV> Iterator;
+
+    vector<Entry> entries; // elementos en orden de insercion (incluye tombstones)
+    uint32_t* buckets;     // indice del primer elemento de cada bucket
+    int nsize;             // total de elementos <key:value> vivos
+    int capacity;          // tamanio del array de buckets
+    int *bucket_sizes;     // guarda la cantidad de elementos en cada bucket
+    int usedBuckets;       // cantidad de buckets ocupados (con al menos un elemento)
+
+public:
+    OrderedChainHash(int initialCapacity = 10){
+        if (initialCapacity <= 0) initialCapacity = 10;
+        this->capacity = initialCapacity;
+        this->buckets = newBuckets(capacity);
+        this->bucket_sizes = new int[capacity]();
+        this->nsize = 0;
+        this->usedBuckets = 0;
+    }
+
+    OrderedChainHash(const OrderedChainHash&) = delete;
+    OrderedChainHash& operator=(const OrderedChainHash&) = delete;
+
+    TV get(const TK& key){
+        uint32_t pos = findEntry(key, getHashCode(key));
+        if (pos == orderedNil) throw std::out_of_range("Key no encontrado");
+        return entries[pos].value;
+    }
+
+    int size(){ return this->nsize; }
+
+    int bucket_count(){ return this->capacity; }
+
+    void set(const TK& key, const TV& value){
+        size_t hashcode = getHashCode(key);
+        uint32_t pos = findEntry(key, hashcode);
+        if (pos != orderedNil) {
+            entries[pos].value = value;
+            return;
+        }
+        if (entries.size() >= (size_t)orderedNil) throw std::length_error("OrderedChainHash lleno");
+
+        size_t index = hashcode % capacity;
+        entries.emplace_back(key, value, hashcode, buckets[index]);
+        buckets[index] = (uint32_t)(entries.size() - 1);
+        if (bucket_sizes[index] == 0) usedBuckets++;
+        bucket_sizes[index]++;
+        nsize++;
+
+        if (bucket_sizes[index] > Rehash::maxColision || Rehash::overloaded(nsize, usedBuckets, capacity)) {
+            rehashing(capacity * 2 + 1);
+        }
+    }
+
+    bool remove(const TK& key){
+        size_t hashcode = getHashCode(key);
+        size_t index = hashcode % capacity;
+
+        uint32_t prev = orderedNil;
+        for (uint32_t pos = buckets[index]; pos != orderedNil; prev = pos, pos = entries[pos].next) {
+            Entry& entry = entries[pos];
+            if (entry.hashcode == hashcode && entry.key == key) {
+                if (prev == orderedNil) buckets[index] = entry.next;
+                else entries[prev].next = entry.next;
+                entry.alive = false;
+                nsize--;
+                bucket_sizes[index]--;
+                if (bucket_sizes[index] == 0) usedBuckets--;
+
+                // si la mitad del vector son tombstones se compacta sin crecer
+                if (entries.size() > 16 && (size_t)nsize * 2 < entries.size()) rehashing(capacity);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(const TK& key){
+        return findEntry(key, getHashCode(key)) != orderedNil;
+    }
+
+    // recorrido en orden de insercion
+    Iterator begin() {
+        return Iterator(entries.data(), entries.data() + entries.size());
+    }
+    Iterator end() {
+        Entry* last = entries.data() + entries.size();
+        return Iterator(last, last);
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        return ChainHashHasher<TK>()(key);
+    }
+
+    static uint32_t* newBuckets(int cap){
+        uint32_t* array = new uint32_t[cap];
+        for (int i = 0; i < cap; ++i) array[i] = orderedNil;
+        return array;
+    }
+
+    uint32_t findEntry(const TK& key, size_t hashcode){
+        for (uint32_t pos = buckets[hashcode % capacity]; pos != orderedNil; pos = entries[pos].next) {
+            const Entry& entry = entries[pos];
+            if (entry.hashcode == hashcode && entry.key == key) return pos;
+        }
+        return orderedNil;
+    }
+
+    // compacta los tombstones (sin alterar el orden) y rearma las cadenas
+    void rehashing(int newCap){
+        size_t alive = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (!entries[i].alive) continue;
+            if (alive != i) entries[alive] = std::move(entries[i]);
+            alive++;
+        }
+        entries.erase(entries.begin() + alive, entries.end());
+
+        delete [] this->buckets;
+        delete [] this->bucket_sizes;
+        this->buckets = newBuckets(newCap);
+        this->bucket_sizes = new int[newCap]();
+        this->capacity = newCap;
+        this->usedBuckets = 0;
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            size_t idx = entries[i].hashcode % newCap;
+            entries[i].next = buckets[idx];
+            buckets[idx] = (uint32_t)i;
+            if (bucket_sizes[idx] == 0) usedBuckets++;
+            bucket_sizes[idx]++;
+        }
+    }
+
+public:
+    ~OrderedChainHash(){
+        delete [] this->buckets;
+        delete [] this->bucket_sizes;
+    }
+};
+
+#endif // ORDEREDHASH_H
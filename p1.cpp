@@ -9,10 +9,8 @@ vector<pair<string, string>> loadCSV(string file);
 
 int main(){
     vector<pair<string, string>> data = loadCSV("smalldata.csv");
-    ChainHash<string, string> hash(13);
-
-    for(size_t i=0;i<data.size();i++)
-        hash.set(data[i].first, data[i].second);
+    // el array se dimensiona una sola vez para todas las filas
+    ChainHash<string, string> hash(data.begin(), data.end());
     
     cout<<"Size of the hash table:"<<hash.bucket_count()<<endl;
 
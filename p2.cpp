@@ -39,15 +39,8 @@ ChainHash<string, vector<int>> bagOfWords(const vector<string>& documentos) {
         unordered_set<string> uniqueWords(tokens.begin(), tokens.end());
 
         for (const auto& word : uniqueWords) {
-            if (result.contains(word)) {
-                vector<int> docs = result.get(word);
-                docs.push_back(static_cast<int>(docIndex));
-                result.set(word, docs);
-            } else {
-                vector<int> docs;
-                docs.push_back(static_cast<int>(docIndex));
-                result.set(word, docs);
-            }
+            // la lista de documentos se crea una sola vez y luego crece en su nodo
+            result[word].push_back(static_cast<int>(docIndex));
         }
     }
 
@@ -58,20 +51,16 @@ ChainHash<string, vector<int>> bagOfWords(const vector<string>& documentos) {
 void printBagOfWords(ChainHash<string, vector<int>>& bow) {
     cout << "{\n";
     
-    // Recorrer todos los buckets para mostrar las palabras
-    for (int i = 0; i < bow.bucket_count(); i++) {
-        if (bow.bucket_size(i) > 0) {
-            for (auto it = bow.begin(i); it != bow.end(i); ++it) {
-                cout << " \"" << (*it).key << "\": [";
-                
-                const vector<int>& docs = (*it).value;
-                for (size_t j = 0; j < docs.size(); j++) {
-                    cout << docs[j];
-                    if (j < docs.size() - 1) cout << ", ";
-                }
-                cout << "],\n";
-            }
+    // Recorrer todas las palabras (el iterador salta los buckets vacios)
+    for (auto it = bow.begin(); it != bow.end(); ++it) {
+        cout << " \"" << (*it).key << "\": [";
+
+        const vector<int>& docs = (*it).value;
+        for (size_t j = 0; j < docs.size(); j++) {
+            cout << docs[j];
+            if (j < docs.size() - 1) cout << ", ";
         }
+        cout << "],\n";
     }
     cout << "}\n";
 }
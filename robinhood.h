@@ -0,0 +1,194 @@
+#ifndef ROBINHOOD_H
+#define ROBINHOOD_H
+
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+using namespace std;
+
+// factor de carga maximo (elementos / slots) expresado como fraccion entera
+const int robinHoodLoadNum = 7;
+const int robinHoodLoadDen = 8;
+
+template<typename TK, typename TV>
+struct RobinHoodSlot {
+    TK key;
+    TV value;
+    size_t hashcode;
+
+    RobinHoodSlot(const TK& k, const TV& v, size_t h)
+        : key(k), value(v), hashcode(h) {}
+};
+
+// Tabla hash de direccionamiento abierto con desplazamiento Robin Hood.
+// Expone la misma interfaz que ChainHash (set/get/remove/contains/size), pero
+// guarda los elementos en un arreglo plano: un lookup recorre slots contiguos
+// en lugar de seguir punteros next.
+template<typename TK, typename TV>
+class RobinHoodHash
+{
+private:
+    typedef RobinHoodSlot<TK, TV> Slot;
+
+    Slot* slots;      // memoria cruda, solo son validos los slots con dist != 0
+    uint16_t* dist;   // distancia de sondeo + 1 de cada slot (0 = vacio)
+    int nsize;        // total de elementos <key:value> insertados
+    int capacity;     // tamanio del arreglo, siempre potencia de 2
+    int shift;        // 64 - log2(capacity), para indexar con Fibonacci
+
+public:
+    RobinHoodHash(int initialCapacity = 16){
+        int cap = 8;
+        while (cap < initialCapacity) cap <<= 1;
+        allocate(cap);
+        this->nsize = 0;
+    }
+
+    RobinHoodHash(const RobinHoodHash&) = delete;
+    RobinHoodHash& operator=(const RobinHoodHash&) = delete;
+
+    TV get(TK key){
+        int pos = findSlot(key, getHashCode(key));
+        if (pos < 0) throw std::out_of_range("Key no encontrado");
+        return this->slots[pos].value;
+    }
+
+    int size(){ return this->nsize; }
+
+    int bucket_count(){ return this->capacity; }
+
+    void set(TK key, TV value){
+        size_t hashcode = getHashCode(key);
+        int pos = findSlot(key, hashcode);
+        if (pos >= 0) {
+            slots[pos].value = value;
+            return;
+        }
+
+        if ((long long)(nsize + 1) * robinHoodLoadDen > (long long)capacity * robinHoodLoadNum) {
+            rehashing(capacity * 2);
+        }
+        insertNew(Slot(key, value, hashcode));
+        nsize++;
+    }
+
+    bool remove(TK key){
+        int pos = findSlot(key, getHashCode(key));
+        if (pos < 0) return false;
+
+        // backward-shift: se recorren hacia atras los elementos desplazados
+        // que siguen, asi no quedan tombstones en la tabla
+        size_t mask = capacity - 1;
+        slots[pos].~Slot();
+        size_t hole = pos;
+        size_t next = (hole + 1) & mask;
+        while (dist[next] > 1) {
+            new (&slots[hole]) Slot(std::move(slots[next]));
+            slots[next].~Slot();
+            dist[hole] = dist[next] - 1;
+            hole = next;
+            next = (next + 1) & mask;
+        }
+        dist[hole] = 0;
+        nsize--;
+        return true;
+    }
+
+    bool contains(TK key){
+        return findSlot(key, getHashCode(key)) >= 0;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        std::hash<TK> ptr_hash;
+        return ptr_hash(key);
+    }
+
+    // hashing de Fibonacci: usa los bits altos del producto, asi claves con
+    // std::hash identidad (enteros) no se agrupan en slots consecutivos
+    size_t homeOf(size_t hashcode){
+        return (size_t)(((uint64_t)hashcode * 11400714819323198485ull) >> shift);
+    }
+
+    int findSlot(const TK& key, size_t hashcode){
+        size_t mask = capacity - 1;
+        size_t pos = homeOf(hashcode);
+        for (uint32_t d = 1; ; ++d) {
+            // un slot vacio o un residente mas cercano a su origen que nosotros
+            // indica que la clave no puede estar mas adelante
+            if (dist[pos] < d) return -1;
+            if (dist[pos] == d && slots[pos].hashcode == hashcode && slots[pos].key == key)
+                return (int)pos;
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    void insertNew(Slot&& slot){
+        Slot cur(std::move(slot));
+        size_t mask = capacity - 1;
+        size_t pos = homeOf(cur.hashcode);
+        uint32_t d = 1;
+        while (true) {
+            if (dist[pos] == 0) {
+                new (&slots[pos]) Slot(std::move(cur));
+                dist[pos] = (uint16_t)d;
+                return;
+            }
+            if (dist[pos] < d) {
+                // Robin Hood: el elemento mas lejos de su origen se queda el slot
+                std::swap(cur, slots[pos]);
+                uint32_t tmp = dist[pos];
+                dist[pos] = (uint16_t)d;
+                d = tmp;
+            }
+            pos = (pos + 1) & mask;
+            d++;
+            if (d == UINT16_MAX) {
+                // sondeo demasiado largo: se crece y se reinserta el pendiente
+                rehashing(capacity * 2);
+                insertNew(std::move(cur));
+                return;
+            }
+        }
+    }
+
+    void allocate(int cap){
+        std::allocator<Slot> alloc;
+        this->slots = alloc.allocate(cap);
+        this->dist = new uint16_t[cap]();
+        this->capacity = cap;
+        this->shift = 64;
+        while (cap > 1) { cap >>= 1; this->shift--; }
+    }
+
+    void release(Slot* oldSlots, uint16_t* oldDist, int oldCap){
+        for (int i = 0; i < oldCap; ++i)
+            if (oldDist[i] != 0) oldSlots[i].~Slot();
+        std::allocator<Slot> alloc;
+        alloc.deallocate(oldSlots, oldCap);
+        delete [] oldDist;
+    }
+
+    void rehashing(int newCap){
+        Slot* oldSlots = this->slots;
+        uint16_t* oldDist = this->dist;
+        int oldCap = this->capacity;
+
+        allocate(newCap);
+        for (int i = 0; i < oldCap; ++i)
+            if (oldDist[i] != 0) insertNew(std::move(oldSlots[i]));
+
+        release(oldSlots, oldDist, oldCap);
+    }
+
+public:
+    ~RobinHoodHash(){
+        release(this->slots, this->dist, this->capacity);
+    }
+};
+
+#endif // ROBINHOOD_H
@@ -0,0 +1,113 @@
+#ifndef SHARDEDHASH_H
+#define SHARDEDHASH_H
+
+#include <mutex>
+#include <cstdint>
+#include "chainhash.h"
+
+// estado de un shard, para detectar claves mal repartidas
+struct ShardStats {
+    int size;          // elementos en el shard
+    int bucket_count;  // capacidad de su array
+    int longest_chain; // bucket mas largo
+};
+
+// N tablas ChainHash independientes, cada una con su mutex. Cada clave va al
+// shard que indican los bits altos de su hash de ruteo, un ChainHashSeededHash
+// con semilla propia del contenedor: sin la semilla, un conjunto de claves
+// armado de antemano podria mandar todo a un mismo shard. Cada shard crece
+// por su cuenta: un rehashing detiene solo 1/N de las claves.
+template<typename TK, typename TV, int N = 16>
+class ShardedChainHash
+{
+private:
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N debe ser potencia de 2");
+
+    struct alignas(64) Shard {
+        std::mutex lock;
+        ChainHash<TK, TV> hash;
+    };
+
+    Shard shards[N];
+    ChainHashSeededHash<TK> router; // solo elige el shard; cada tabla tiene su semilla
+
+public:
+    ShardedChainHash() {}
+
+    ShardedChainHash(const ShardedChainHash&) = delete;
+    ShardedChainHash& operator=(const ShardedChainHash&) = delete;
+
+    TV get(const TK& key){
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.hash.get(key);
+    }
+
+    int size(){
+        int total = 0;
+        for (int i = 0; i < N; ++i) {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            total += shards[i].hash.size();
+        }
+        return total;
+    }
+
+    int shard_count(){ return N; }
+
+    void set(const TK& key, const TV& value){
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.hash.set(key, value);
+    }
+
+    bool remove(const TK& key){
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.hash.remove(key);
+    }
+
+    bool contains(const TK& key){
+        Shard& shard = shardOf(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.hash.contains(key);
+    }
+
+    ShardStats shard_stats(int index){
+        if (index < 0 || index >= N) throw std::out_of_range("Indice de shard invalido");
+        Shard& shard = shards[index];
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        ShardStats stats;
+        stats.size = shard.hash.size();
+        stats.bucket_count = shard.hash.bucket_count();
+        stats.longest_chain = 0;
+        for (int b = 0; b < stats.bucket_count; ++b)
+            if (shard.hash.bucket_size(b) > stats.longest_chain)
+                stats.longest_chain = shard.hash.bucket_size(b);
+        return stats;
+    }
+
+    vector<ShardStats> stats(){
+        vector<ShardStats> all;
+        for (int i = 0; i < N; ++i) all.push_back(shard_stats(i));
+        return all;
+    }
+
+private:
+    static constexpr int shardBits(){
+        int bits = 0;
+        while ((1 << bits) < N) bits++;
+        return bits;
+    }
+
+    Shard& shardOf(const TK& key){
+        if constexpr (N == 1) {
+            return shards[0];
+        } else {
+            // la salida del hash con semilla ya esta mezclada: sirven los bits altos
+            return shards[(uint64_t)router(key) >> (64 - shardBits())];
+        }
+    }
+};
+
+#endif // SHARDEDHASH_H
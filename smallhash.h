@@ -0,0 +1,144 @@
+#ifndef SMALLHASH_H
+#define SMALLHASH_H
+
+#include <new>
+#include "chainhash.h"
+
+template<typename TK, typename TV>
+struct SmallChainHashEntry {
+    TK key;
+    TV value;
+
+    template<typename K, typename V>
+    SmallChainHashEntry(K&& k, V&& v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {}
+};
+
+// ChainHash con optimizacion para tablas chicas: hasta N elementos viven en
+// un arreglo dentro del objeto y se buscan linealmente, sin hashear ni pedir
+// memoria. Al insertar el elemento N+1 se pasan todos a un ChainHash en el
+// heap, que se usa desde ahi en adelante. Crear y destruir una tabla chica no
+// toca el heap.
+template<typename TK, typename TV, int N = 8, typename Hash = ChainHashSeededHash<TK>,
+         typename KeyEqual = std::equal_to<>>
+class SmallChainHash
+{
+private:
+    static_assert(N > 0, "N debe ser positivo");
+
+    typedef SmallChainHashEntry<TK, TV> Entry;
+    typedef ChainHash<TK, TV, Hash, KeyEqual> Table;
+
+    alignas(Entry) unsigned char storage[N * sizeof(Entry)]; // memoria cruda, validas las primeras count
+    int count;      // elementos en storage
+    Table* table;   // nullptr mientras los elementos entren en storage
+    KeyEqual keyEqual;
+
+public:
+    SmallChainHash() : count(0), table(nullptr) {}
+
+    SmallChainHash(const SmallChainHash&) = delete;
+    SmallChainHash& operator=(const SmallChainHash&) = delete;
+
+    SmallChainHash(SmallChainHash&& other) : count(0), table(other.table), keyEqual(other.keyEqual) {
+        other.table = nullptr;
+        for (int i = 0; i < other.count; ++i) {
+            new (entry(i)) Entry(std::move(other.entry(i)->key), std::move(other.entry(i)->value));
+            other.entry(i)->~Entry();
+        }
+        this->count = other.count;
+        other.count = 0;
+    }
+
+    TV get(const TK& key){
+        if (table != nullptr) return table->get(key);
+        Entry* e = findEntry(key);
+        if (e == nullptr) throw std::out_of_range("Key no encontrado");
+        return e->value;
+    }
+
+    int size(){ return table != nullptr ? table->size() : count; }
+
+    // true mientras los elementos sigan en el arreglo interno
+    bool is_inline(){ return table == nullptr; }
+
+    void set(const TK& key, const TV& value){
+        if (table == nullptr) {
+            Entry* e = findEntry(key);
+            if (e != nullptr) {
+                e->value = value;
+                return;
+            }
+            if (count < N) {
+                new (entry(count)) Entry(key, value);
+                count++;
+                return;
+            }
+            spill();
+        }
+        table->set(key, value);
+    }
+
+    TV& operator[](const TK& key){
+        if (table == nullptr) {
+            Entry* e = findEntry(key);
+            if (e != nullptr) return e->value;
+            if (count < N) {
+                Entry* created = new (entry(count)) Entry(key, TV());
+                count++;
+                return created->value;
+            }
+            spill();
+        }
+        return (*table)[key];
+    }
+
+    bool remove(const TK& key){
+        if (table != nullptr) return table->remove(key);
+        Entry* e = findEntry(key);
+        if (e == nullptr) return false;
+        // el ultimo ocupa el hueco: el orden del arreglo no importa
+        Entry* last = entry(count - 1);
+        if (e != last) {
+            e->key = std::move(last->key);
+            e->value = std::move(last->value);
+        }
+        last->~Entry();
+        count--;
+        return true;
+    }
+
+    bool contains(const TK& key){
+        if (table != nullptr) return table->contains(key);
+        return findEntry(key) != nullptr;
+    }
+
+private:
+    Entry* entry(int i){
+        return std::launder(reinterpret_cast<Entry*>(storage + i * sizeof(Entry)));
+    }
+
+    Entry* findEntry(const TK& key){
+        for (int i = 0; i < count; ++i)
+            if (keyEqual(entry(i)->key, key)) return entry(i);
+        return nullptr;
+    }
+
+    // pasa los elementos del arreglo interno a un ChainHash en el heap
+    void spill(){
+        table = new Table();
+        table->reserve(N * 2);
+        for (int i = 0; i < count; ++i) {
+            table->set(std::move(entry(i)->key), std::move(entry(i)->value));
+            entry(i)->~Entry();
+        }
+        count = 0;
+    }
+
+public:
+    ~SmallChainHash(){
+        for (int i = 0; i < count; ++i) entry(i)->~Entry();
+        delete table;
+    }
+};
+
+#endif // SMALLHASH_H
@@ -0,0 +1,169 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <cstring>
+#include "chainhash.h"
+
+// Copia strings a bloques contiguos que se liberan todos juntos. Los bloques
+// no se mueven, asi que los string_view devueltos por store() valen mientras
+// viva la arena. No hay borrado individual: lo que se deja de usar queda en
+// su bloque hasta destruir la arena.
+class StringArena {
+private:
+    vector<char*> blocks;  // bloques reservados
+    char* cursor;          // siguiente byte libre del ultimo bloque
+    char* blockEnd;
+    size_t nextBlockSize;
+    size_t usedBytes;      // bytes copiados
+    size_t reservedBytes;  // bytes en todos los bloques
+
+    static const size_t maxBlockSize = 1 << 20;
+
+public:
+    StringArena(size_t firstBlockSize = 4096)
+        : cursor(nullptr), blockEnd(nullptr),
+          nextBlockSize(firstBlockSize > 0 ? firstBlockSize : 4096),
+          usedBytes(0), reservedBytes(0) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    StringArena(StringArena&& other)
+        : blocks(std::move(other.blocks)), cursor(other.cursor), blockEnd(other.blockEnd),
+          nextBlockSize(other.nextBlockSize), usedBytes(other.usedBytes),
+          reservedBytes(other.reservedBytes) {
+        other.blocks.clear();
+        other.cursor = other.blockEnd = nullptr;
+        other.usedBytes = other.reservedBytes = 0;
+    }
+
+    // copia text a la arena y devuelve la vista de la copia
+    string_view store(string_view text){
+        if ((size_t)(blockEnd - cursor) < text.size()) grow(text.size());
+        char* copy = cursor;
+        if (!text.empty()) memcpy(copy, text.data(), text.size());
+        cursor += text.size();
+        usedBytes += text.size();
+        return string_view(copy, text.size());
+    }
+
+    size_t used_bytes() const { return usedBytes; }
+    size_t reserved_bytes() const { return reservedBytes; }
+
+    ~StringArena(){
+        for (char* block : blocks) delete [] block;
+    }
+
+private:
+    // un string mas largo que el bloque siguiente recibe un bloque a medida
+    void grow(size_t needed){
+        size_t size = needed > nextBlockSize ? needed : nextBlockSize;
+        char* block = new char[size];
+        blocks.push_back(block);
+        cursor = block;
+        blockEnd = block + size;
+        reservedBytes += size;
+        if (nextBlockSize < maxBlockSize) nextBlockSize *= 2;
+    }
+};
+
+// Deduplica strings: intern() devuelve siempre la misma vista para el mismo
+// contenido, copiandolo a la arena solo la primera vez.
+class StringInternPool {
+private:
+    StringArena& arena;
+    ChainHash<string_view, string_view> views; // contenido -> copia en la arena
+
+public:
+    StringInternPool(StringArena& arena) : arena(arena) {}
+
+    StringInternPool(const StringInternPool&) = delete;
+    StringInternPool& operator=(const StringInternPool&) = delete;
+
+    string_view intern(string_view text){
+        string_view* found = views.find(text);
+        if (found != nullptr) return *found;
+        string_view copy = arena.store(text);
+        views.set(copy, copy);
+        return copy;
+    }
+
+    int size(){ return views.size(); }
+};
+
+// ChainHash de strings cuyas claves y valores viven en una arena de la tabla:
+// los nodos guardan string_view (16 bytes cada uno en lugar de un std::string
+// de 32 con su propio buffer si no entra en SSO) y, con internValues, los
+// valores repetidos (categorias como "Electronics") se guardan una sola vez.
+// Las vistas devueltas valen mientras viva la tabla; remove y los set que
+// reemplazan un valor no devuelven su espacio a la arena.
+template<typename Indexing = ModIndexing, typename Rehash = DefaultRehashPolicy>
+class ArenaChainHash
+{
+private:
+    typedef ChainHash<string_view, string_view, ChainHashSeededHash<string_view>,
+                      std::equal_to<>, Indexing, Rehash> Table;
+
+    StringArena arena;
+    StringInternPool values;
+    Table table;
+    bool internValues;
+
+public:
+    ArenaChainHash(int initialCapacity = 10, bool internValues = true)
+        : values(arena), table(initialCapacity), internValues(internValues) {}
+
+    // carga masiva como la de ChainHash: copia todo a la arena y arma la tabla
+    // de una vez (una clave repetida deja su copia anterior en la arena)
+    template<typename It, typename = typename std::iterator_traits<It>::iterator_category>
+    ArenaChainHash(It first, It last, bool internValues = true)
+        : values(arena), table(storeAll(first, last, internValues)), internValues(internValues) {}
+
+    ArenaChainHash(const ArenaChainHash&) = delete;
+    ArenaChainHash& operator=(const ArenaChainHash&) = delete;
+
+    string_view get(string_view key){ return table.get(key); }
+
+    optional<string_view> try_get(string_view key){
+        string_view* value = table.find(key);
+        if (value == nullptr) return nullopt;
+        return *value;
+    }
+
+    void set(string_view key, string_view value){
+        string_view stored = internValues ? values.intern(value) : arena.store(value);
+        string_view* current = table.find(key);
+        if (current != nullptr) *current = stored;
+        else table.set(arena.store(key), stored);
+    }
+
+    bool remove(string_view key){ return table.remove(key); }
+
+    bool contains(string_view key){ return table.contains(key); }
+
+    int size(){ return table.size(); }
+
+    int bucket_count(){ return table.bucket_count(); }
+
+    int bucket_size(int index){ return table.bucket_size(index); }
+
+    // bytes de la arena ocupados por claves y valores
+    size_t arena_bytes() const { return arena.used_bytes(); }
+
+    auto begin(int index){ return table.begin(index); }
+    auto end(int index){ return table.end(index); }
+    auto begin(){ return table.begin(); }
+    auto end(){ return table.end(); }
+
+private:
+    template<typename It>
+    vector<pair<string_view, string_view>> storeAll(It first, It last, bool intern){
+        vector<pair<string_view, string_view>> stored;
+        for (; first != last; ++first)
+            stored.push_back({arena.store(first->first),
+                              intern ? values.intern(first->second) : arena.store(first->second)});
+        return stored;
+    }
+};
+
+#endif // STRINGARENA_H
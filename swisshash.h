@@ -0,0 +1,240 @@
+#ifndef SWISSHASH_H
+#define SWISSHASH_H
+
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// bytes de control: >= 0 es un slot ocupado (guarda los 7 bits H2 del hash)
+const int8_t swissEmpty = -128;   // 0b10000000
+const int8_t swissDeleted = -2;   // 0b11111110 (tombstone)
+const int swissGroupWidth = 16;
+
+template<typename TK, typename TV>
+struct SwissSlot {
+    TK key;
+    TV value;
+
+    SwissSlot(const TK& k, const TV& v) : key(k), value(v) {}
+};
+
+// Grupo de 16 bytes de control. Cada match devuelve una mascara de bits con un
+// bit por slot del grupo que cumple la condicion.
+class SwissGroup {
+public:
+    explicit SwissGroup(const int8_t* ctrl) {
+#ifdef __SSE2__
+        this->data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        this->data = ctrl;
+#endif
+    }
+
+    uint32_t match(int8_t tag) const {
+#ifdef __SSE2__
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), data));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < swissGroupWidth; ++i)
+            if (data[i] == tag) mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    uint32_t matchEmpty() const { return match(swissEmpty); }
+
+    // vacio o tombstone: ambos tienen el bit de signo encendido
+    uint32_t matchFree() const {
+#ifdef __SSE2__
+        return (uint32_t)_mm_movemask_epi8(data);
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < swissGroupWidth; ++i)
+            if (data[i] < 0) mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+private:
+#ifdef __SSE2__
+    __m128i data;
+#else
+    const int8_t* data;
+#endif
+};
+
+// Tabla hash estilo Swiss table: un arreglo separado de bytes de control con un
+// tag de 7 bits por slot que se compara de 16 en 16 (SSE2). Un miss casi nunca
+// toca una clave: basta con que ningun tag del grupo coincida y que el grupo
+// tenga un slot vacio. Misma interfaz que ChainHash (set/get/remove/contains/size).
+template<typename TK, typename TV>
+class SwissHash
+{
+private:
+    typedef SwissSlot<TK, TV> Slot;
+
+    int8_t* ctrl;     // bytes de control, uno por slot
+    Slot* slots;      // memoria cruda, solo son validos los slots con ctrl >= 0
+    int nsize;        // total de elementos <key:value> insertados
+    int tombstones;   // slots marcados como swissDeleted
+    int capacity;     // numero de slots, multiplo de swissGroupWidth
+    size_t groupMask; // (cantidad de grupos - 1), la cantidad es potencia de 2
+
+public:
+    SwissHash(int initialCapacity = 16){
+        int cap = swissGroupWidth;
+        while (cap < initialCapacity) cap <<= 1;
+        allocate(cap);
+        this->nsize = 0;
+    }
+
+    SwissHash(const SwissHash&) = delete;
+    SwissHash& operator=(const SwissHash&) = delete;
+
+    TV get(TK key){
+        int pos = findSlot(key, mix(getHashCode(key)));
+        if (pos < 0) throw std::out_of_range("Key no encontrado");
+        return this->slots[pos].value;
+    }
+
+    int size(){ return this->nsize; }
+
+    int bucket_count(){ return this->capacity; }
+
+    void set(TK key, TV value){
+        size_t h = mix(getHashCode(key));
+        int pos = findSlot(key, h);
+        if (pos >= 0) {
+            slots[pos].value = value;
+            return;
+        }
+
+        // carga maxima de 7/8 contando los tombstones, que tambien alargan los sondeos
+        if ((long long)(nsize + tombstones + 1) * 8 > (long long)capacity * 7) {
+            // si la mayoria de lo ocupado son tombstones basta con limpiar
+            rehashing(nsize * 2 >= capacity ? capacity * 2 : capacity);
+        }
+        insertNew(Slot(key, value), h);
+        nsize++;
+    }
+
+    bool remove(TK key){
+        size_t h = mix(getHashCode(key));
+        int pos = findSlot(key, h);
+        if (pos < 0) return false;
+
+        slots[pos].~Slot();
+        // si el grupo ya tiene un vacio, los sondeos que pasen por aqui se detienen
+        // igual, asi que el slot puede volver a vacio en vez de tombstone
+        const int8_t* groupStart = ctrl + (pos & ~(swissGroupWidth - 1));
+        if (SwissGroup(groupStart).matchEmpty() != 0) {
+            ctrl[pos] = swissEmpty;
+        } else {
+            ctrl[pos] = swissDeleted;
+            tombstones++;
+        }
+        nsize--;
+        return true;
+    }
+
+    bool contains(TK key){
+        return findSlot(key, mix(getHashCode(key))) >= 0;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        std::hash<TK> ptr_hash;
+        return ptr_hash(key);
+    }
+
+    // std::hash de enteros es la identidad; se mezcla para que H1 y H2 salgan
+    // de bits con entropia
+    static size_t mix(size_t hashcode){
+        uint64_t m = (uint64_t)hashcode * 11400714819323198485ull;
+        return (size_t)(m ^ (m >> 32));
+    }
+
+    static int8_t tagOf(size_t h){ return (int8_t)(h & 0x7F); }
+    size_t groupOf(size_t h){ return (h >> 7) & groupMask; }
+
+    int findSlot(const TK& key, size_t h){
+        int8_t tag = tagOf(h);
+        size_t group = groupOf(h);
+        // sondeo triangular sobre grupos: visita todos si la cantidad es potencia de 2
+        for (size_t step = 1; step <= groupMask + 1; ++step) {
+            int base = (int)(group * swissGroupWidth);
+            SwissGroup g(ctrl + base);
+            for (uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+                int pos = base + __builtin_ctz(m);
+                if (slots[pos].key == key) return pos;
+            }
+            if (g.matchEmpty() != 0) return -1;
+            group = (group + step) & groupMask;
+        }
+        return -1;
+    }
+
+    void insertNew(Slot&& slot, size_t h){
+        size_t group = groupOf(h);
+        for (size_t step = 1; ; ++step) {
+            int base = (int)(group * swissGroupWidth);
+            uint32_t m = SwissGroup(ctrl + base).matchFree();
+            if (m != 0) {
+                int pos = base + __builtin_ctz(m);
+                if (ctrl[pos] == swissDeleted) tombstones--;
+                new (&slots[pos]) Slot(std::move(slot));
+                ctrl[pos] = tagOf(h);
+                return;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    void allocate(int cap){
+        std::allocator<Slot> alloc;
+        this->slots = alloc.allocate(cap);
+        this->ctrl = new int8_t[cap];
+        for (int i = 0; i < cap; ++i) this->ctrl[i] = swissEmpty;
+        this->capacity = cap;
+        this->groupMask = (size_t)(cap / swissGroupWidth) - 1;
+        this->tombstones = 0;
+    }
+
+    void release(int8_t* oldCtrl, Slot* oldSlots, int oldCap){
+        for (int i = 0; i < oldCap; ++i)
+            if (oldCtrl[i] >= 0) oldSlots[i].~Slot();
+        std::allocator<Slot> alloc;
+        alloc.deallocate(oldSlots, oldCap);
+        delete [] oldCtrl;
+    }
+
+    void rehashing(int newCap){
+        int8_t* oldCtrl = this->ctrl;
+        Slot* oldSlots = this->slots;
+        int oldCap = this->capacity;
+
+        allocate(newCap);
+        for (int i = 0; i < oldCap; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            size_t h = mix(getHashCode(oldSlots[i].key));
+            insertNew(std::move(oldSlots[i]), h);
+        }
+
+        release(oldCtrl, oldSlots, oldCap);
+    }
+
+public:
+    ~SwissHash(){
+        release(this->ctrl, this->slots, this->capacity);
+    }
+};
+
+#endif // SWISSHASH_H
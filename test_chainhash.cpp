@@ -0,0 +1,155 @@
+#define CHAINHASH_STATS
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <cctype>
+#include "chainhash.h"
+
+using namespace std;
+
+// cada par de claves consecutivas comparte el hash: usedBuckets ~ nsize / 2
+struct PairHash {
+    size_t operator()(int key) const { return chainHashMix64((uint64_t)(key / 2)); }
+};
+
+// igualdad sin distinguir mayusculas; el hash es el mismo para todas las
+// claves del mismo largo, asi que todas caen en una cadena degenerada
+struct CaseInsensitiveEqual {
+    bool operator()(const string& a, const string& b) const {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++)
+            if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+        return true;
+    }
+};
+
+// identidad para las claves positivas; las negativas comparten el hashcode 0
+struct IdentityHash {
+    size_t operator()(int key) const { return key < 0 ? 0 : (size_t)key; }
+};
+
+// cadena mas larga de la tabla
+template<typename Table>
+int longestChain(Table& hash){
+    int longest = 0;
+    for (int i = 0; i < hash.bucket_count(); i++)
+        if (hash.bucket_size(i) > longest) longest = hash.bucket_size(i);
+    return longest;
+}
+
+struct LengthHash {
+    size_t operator()(const string& key) const { return key.size(); }
+};
+
+// borrar todas las claves achica con histeresis: la cantidad de rehashings
+// crece con el logaritmo de los elementos, no con los elementos
+void testShrinkHysteresis(){
+    const int n = 40000;
+    // maxColision = 8: con 3, dos pares en un bucket ya pasan el limite y la
+    // carga crece sin control antes de llegar a probar el achicamiento
+    ChainHash<int, int, PairHash, std::equal_to<>, ModIndexing, BucketFillPolicy<8>> hash;
+    for (int i = 0; i < n; i++) hash.set(i, i);
+    hash.reset_stats();
+    for (int i = 0; i < n; i++) assert(hash.remove(i));
+    assert(hash.size() == 0);
+    assert(hash.stats().rehashes <= 32);
+
+    ChainHash<int, int> plain;
+    for (int i = 0; i < n; i++) plain.set(i, i);
+    plain.reset_stats();
+    for (int i = 0; i < n; i++) assert(plain.remove(i));
+    assert(plain.stats().rehashes <= 32);
+    assert(plain.bucket_count() < 100);
+}
+
+// el achicamiento automatico respeta la capacidad pedida; shrink_to_fit no
+void testShrinkKeepsRequestedCapacity(){
+    ChainHash<int, int> reserved;
+    reserved.reserve(100000);
+    int cap = reserved.bucket_count();
+    reserved.set(1, 1);
+    reserved.remove(1);
+    assert(reserved.bucket_count() == cap);
+    reserved.shrink_to_fit();
+    assert(reserved.bucket_count() < cap);
+
+    ChainHash<int, int> sized(1 << 20);
+    sized.set(1, 1);
+    sized.remove(1);
+    assert(sized.bucket_count() == 1 << 20);
+}
+
+// reserve(n) y la carga masiva alcanzan para n elementos sin rehashing, aunque
+// algun bucket pase de maxColision; pasando de n las colisiones vuelven a
+// hacer crecer la tabla
+void testReserveAvoidsRehashing(){
+    const int n = 100000;
+    ChainHash<int, int> reserved;
+    reserved.reserve(n);
+    int cap = reserved.bucket_count();
+    reserved.reset_stats();
+    for (int i = 0; i < n; i++) reserved.set(i, i);
+    assert(reserved.stats().rehashes == 0);
+    assert(reserved.bucket_count() == cap);
+
+    vector<pair<int, int>> rows;
+    for (int i = 0; i < n; i++) rows.push_back({i, i});
+    ChainHash<int, int> bulk(rows);
+    assert(bulk.stats().rehashes == 0);
+    for (int i = 0; i < n; i++) assert(bulk.get(i) == i);
+
+    // con todas las claves en pocos buckets el factor de carga no dispara
+    const int skewed = 20000;
+    ChainHash<int, int, IdentityHash> small;
+    small.reserve(100);
+    for (int i = 0; i < skewed; i++) small.set(i * 126, i);
+    assert(small.bucket_count() > skewed);
+    assert(longestChain(small) <= DefaultRehashPolicy::maxColision);
+}
+
+// con un KeyEqual propio no se arman bins (ordenan con operator<), pero la
+// cadena degenerada sigue sin disparar rehashings
+void testDegenerateChainUsesKeyEqual(){
+    ChainHash<string, int, LengthHash, CaseInsensitiveEqual> hash;
+    const int n = 40;
+    for (int i = 0; i < n; i++) hash.set("key" + to_string(100 + i), i);
+    int cap = hash.bucket_count();
+    for (int i = 0; i < n; i++) hash.set("KEY" + to_string(100 + i), i + n);
+    assert(hash.size() == n);
+    assert(hash.bucket_count() == cap);
+    for (int i = 0; i < n; i++) assert(hash.get("Key" + to_string(100 + i)) == i + n);
+    for (int i = 0; i < n; i += 2) assert(hash.remove("kEy" + to_string(100 + i)));
+    assert(hash.size() == n / 2);
+    for (int i = 0; i < n; i++) assert(hash.contains("key" + to_string(100 + i)) == (i % 2 == 1));
+}
+
+// una cadena larga de hashcodes distintos no recibe bin al rehashear: la
+// tabla sigue creciendo por colisiones hasta separarla
+void testLongChainOfDistinctHashesGrows(){
+    const int n = 40000;
+    ChainHash<int, int, IdentityHash> hash;
+    for (int i = 0; i < n; i++) hash.set(i * 126, i);
+    assert(hash.bucket_count() > n);
+    assert(longestChain(hash) <= DefaultRehashPolicy::maxColision);
+    for (int i = 0; i < n; i++) assert(hash.get(i * 126) == i);
+
+    // el bucket del bin tambien crece por los nodos que no son degenerados
+    const int same = 20;
+    ChainHash<int, int, IdentityHash> mixed;
+    for (int i = 1; i <= same; i++) mixed.set(-i, i);
+    for (int i = 0; i < n; i++) mixed.set(i * 126, i);
+    assert(mixed.bucket_count() > n);
+    assert(longestChain(mixed) <= same + DefaultRehashPolicy::maxColision);
+    for (int i = 1; i <= same; i++) assert(mixed.get(-i) == i);
+    for (int i = 0; i < n; i++) assert(mixed.get(i * 126) == i);
+}
+
+int main(){
+    testShrinkHysteresis();
+    testShrinkKeepsRequestedCapacity();
+    testReserveAvoidsRehashing();
+    testDegenerateChainUsesKeyEqual();
+    testLongChainOfDistinctHashesGrows();
+    cout << "OK" << endl;
+    return 0;
+}
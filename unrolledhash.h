@@ -0,0 +1,247 @@
+#ifndef UNROLLEDHASH_H
+#define UNROLLEDHASH_H
+
+#include <cstdint>
+#include <new>
+#include "chainhash.h"
+
+// ocupacion media de los bloques antes de crecer (elementos / (buckets * K))
+const int unrolledLoadNum = 1;
+const int unrolledLoadDen = 2;
+
+template<typename TK, typename TV>
+struct UnrolledChainEntry {
+    TK key;
+    TV value;
+
+    template<typename K, typename V>
+    UnrolledChainEntry(K&& k, V&& v) : key(std::forward<K>(k)), value(std::forward<V>(v)) {}
+};
+
+// Bloque de una cadena desenrollada: hasta K entradas con un tag de 8 bits del
+// hash de cada una. La cabecera (next, count, tags) va al principio de la
+// linea de cache, asi que un miss se descarta comparando tags sin leer claves.
+template<typename TK, typename TV, int K>
+struct alignas(64) UnrolledChainBlock {
+    typedef UnrolledChainEntry<TK, TV> Entry;
+
+    UnrolledChainBlock* next;
+    uint8_t count;   // entradas validas, siempre las primeras count
+    uint8_t tags[K]; // bits altos del hashcode de cada entrada
+    alignas(Entry) unsigned char storage[K * sizeof(Entry)];
+
+    UnrolledChainBlock(UnrolledChainBlock* n) : next(n), count(0), tags() {}
+
+    // un bit por entrada valida cuyo tag es tag; se comparan los K tags sin
+    // saltos y el compilador puede vectorizarlo
+    uint64_t match(uint8_t tag) const {
+        uint64_t mask = 0;
+        for (int i = 0; i < K; ++i) mask |= (uint64_t)(tags[i] == tag) << i;
+        return mask & ((1ull << count) - 1);
+    }
+
+    Entry* entry(int i){
+        return std::launder(reinterpret_cast<Entry*>(storage + i * sizeof(Entry)));
+    }
+};
+
+// bytes de un bloque de k entradas sin el relleno final: la cabecera (next,
+// count y k tags) redondeada a la alineacion de las entradas, mas las entradas
+template<typename TK, typename TV>
+constexpr size_t unrolledBlockBytes(int k){
+    size_t align = alignof(UnrolledChainEntry<TK, TV>);
+    size_t header = sizeof(void*) + 1 + k;
+    return (header + align - 1) / align * align + k * sizeof(UnrolledChainEntry<TK, TV>);
+}
+
+// cuantas entradas entran en una linea de cache con su cabecera, entre 3 (una
+// cadena de maxColision elementos en un solo bloque) y 16
+template<typename TK, typename TV>
+constexpr int unrolledDefaultEntries(){
+    int k = 16;
+    while (k > 3 && unrolledBlockBytes<TK, TV>(k) > 64) k--;
+    return k;
+}
+
+// Variante de ChainHash con cadenas desenrolladas: cada nodo de la cadena es
+// un bloque alineado a 64 bytes con hasta K entradas y sus tags, en lugar de
+// un nodo por entrada. Con la ocupacion por defecto casi todos los buckets
+// tienen un solo bloque, asi que un lookup toca una linea de cache (mas la de
+// la entrada si no entra en la misma). Las entradas se mueven dentro de su
+// bloque al borrar y entre bloques al crecer: no se guardan punteros a ellas.
+template<typename TK, typename TV, int K = unrolledDefaultEntries<TK, TV>(),
+         typename Hash = ChainHashSeededHash<TK>, typename KeyEqual = std::equal_to<>>
+class UnrolledChainHash
+{
+private:
+    static_assert(K > 0 && K < 64, "K debe estar entre 1 y 63");
+    // con K por defecto el bloque ocupa una sola linea de cache, salvo que ni
+    // 3 entradas entren en ella
+    static_assert(K != unrolledDefaultEntries<TK, TV>() || unrolledBlockBytes<TK, TV>(3) > 64 ||
+                  sizeof(UnrolledChainBlock<TK, TV, K>) == 64,
+                  "el bloque por defecto debe ocupar 64 bytes");
+
+    typedef UnrolledChainBlock<TK, TV, K> Block;
+    typedef UnrolledChainEntry<TK, TV> Entry;
+
+    Block** array;                 // primer bloque de cada bucket
+    int nsize;                     // total de elementos <key:value> insertados
+    int capacity;                  // tamanio del array
+    ChainHashNodePool<Block> pool; // de aqui salen todos los bloques
+    Hash hasher;
+    KeyEqual keyEqual;
+
+public:
+    UnrolledChainHash(int initialCapacity = 10) : pool(initialCapacity){
+        if (initialCapacity <= 0) initialCapacity = 10;
+        this->capacity = initialCapacity;
+        this->array = new Block*[capacity]();
+        this->nsize = 0;
+    }
+
+    UnrolledChainHash(const UnrolledChainHash&) = delete;
+    UnrolledChainHash& operator=(const UnrolledChainHash&) = delete;
+
+    TV get(const TK& key){
+        Entry* e = findEntry(key, getHashCode(key));
+        if (e == nullptr) throw std::out_of_range("Key no encontrado");
+        return e->value;
+    }
+
+    int size(){ return this->nsize; }
+
+    int bucket_count(){ return this->capacity; }
+
+    // bloques en la cadena del bucket index
+    int bucket_blocks(int index){
+        int blocks = 0;
+        for (Block* b = array[index]; b != nullptr; b = b->next) blocks++;
+        return blocks;
+    }
+
+    void set(const TK& key, const TV& value){
+        size_t hashcode = getHashCode(key);
+        Entry* e = findEntry(key, hashcode);
+        if (e != nullptr) {
+            e->value = value;
+            return;
+        }
+        insertNew(key, value, hashcode);
+        nsize++;
+
+        if ((long long)nsize * unrolledLoadDen > (long long)capacity * K * unrolledLoadNum) {
+            rehashing(capacity * 2 + 1);
+        }
+    }
+
+    bool remove(const TK& key){
+        size_t hashcode = getHashCode(key);
+        size_t index = hashcode % capacity;
+        uint8_t tag = tagOf(hashcode);
+
+        Block* prev = nullptr;
+        for (Block* b = array[index]; b != nullptr; prev = b, b = b->next) {
+            for (uint64_t m = b->match(tag); m != 0; m &= m - 1) {
+                int i = __builtin_ctzll(m);
+                if (!keyEqual(b->entry(i)->key, key)) continue;
+                // la ultima entrada del bloque ocupa el hueco
+                int last = b->count - 1;
+                if (i != last) {
+                    *b->entry(i) = std::move(*b->entry(last));
+                    b->tags[i] = b->tags[last];
+                }
+                b->entry(last)->~Entry();
+                b->count--;
+                if (b->count == 0) {
+                    if (prev == nullptr) array[index] = b->next;
+                    else prev->next = b->next;
+                    pool.destroy(b);
+                }
+                nsize--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(const TK& key){
+        return findEntry(key, getHashCode(key)) != nullptr;
+    }
+
+private:
+    size_t getHashCode(const TK& key){
+        return hasher(key);
+    }
+
+    // el indice sale de los bits bajos (% capacity) y el tag de los altos
+    static uint8_t tagOf(size_t hashcode){
+        return (uint8_t)(hashcode >> (sizeof(size_t) * 8 - 8));
+    }
+
+    Entry* findEntry(const TK& key, size_t hashcode){
+        uint8_t tag = tagOf(hashcode);
+        for (Block* b = array[hashcode % capacity]; b != nullptr; b = b->next) {
+            for (uint64_t m = b->match(tag); m != 0; m &= m - 1) {
+                Entry* e = b->entry(__builtin_ctzll(m));
+                if (keyEqual(e->key, key)) return e;
+            }
+        }
+        return nullptr;
+    }
+
+    // agrega al primer bloque del bucket con lugar, o a un bloque nuevo al inicio
+    template<typename KK, typename VV>
+    void insertNew(KK&& key, VV&& value, size_t hashcode){
+        size_t index = hashcode % capacity;
+        Block* b = array[index];
+        while (b != nullptr && b->count == K) b = b->next;
+        if (b == nullptr) {
+            b = pool.create(array[index]);
+            array[index] = b;
+        }
+        new (b->entry(b->count)) Entry(std::forward<KK>(key), std::forward<VV>(value));
+        b->tags[b->count] = tagOf(hashcode);
+        b->count++;
+    }
+
+    // redistribuye las entradas en bloques nuevos de un array de newCap buckets
+    void rehashing(int newCap){
+        Block** oldArray = this->array;
+        int oldCap = this->capacity;
+        this->array = new Block*[newCap]();
+        this->capacity = newCap;
+
+        for (int i = 0; i < oldCap; ++i) {
+            Block* b = oldArray[i];
+            while (b != nullptr) {
+                Block* next = b->next;
+                for (int j = 0; j < b->count; ++j) {
+                    Entry* e = b->entry(j);
+                    size_t hashcode = getHashCode(e->key);
+                    insertNew(std::move(e->key), std::move(e->value), hashcode);
+                    e->~Entry();
+                }
+                pool.destroy(b);
+                b = next;
+            }
+        }
+        delete [] oldArray;
+    }
+
+public:
+    ~UnrolledChainHash(){
+        for (int i = 0; i < capacity; ++i) {
+            Block* b = array[i];
+            while (b != nullptr) {
+                Block* next = b->next;
+                for (int j = 0; j < b->count; ++j) b->entry(j)->~Entry();
+                b->~Block();
+                b = next;
+            }
+        }
+        pool.release();
+        delete [] array;
+    }
+};
+
+#endif // UNROLLEDHASH_H